@@ -0,0 +1,576 @@
+#include "Engine/Async/JobSystem.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/AlignedAllocation.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <new>
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define JOB_INDEX_MASK			(JOB_MAX_JOBS_PER_WORKER - 1)
+#define JOB_IDLE_SPIN_COUNT		64
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static JobSystem*				g_jobSystem = nullptr;
+static thread_local int			t_workerIndex = -1; // -1 for threads that are not job workers
+
+//-----------------------------------------------------------------------------------------------
+// Pushes a job onto the bottom of the deque (Owner thread only)
+//
+bool JobDeque::Push(Job* job)
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_acquire);
+
+	if(bottom - top >= JOB_MAX_JOBS_PER_WORKER)
+	{
+		return false; // Full
+	}
+
+	m_jobs[bottom & JOB_INDEX_MASK].store(job, std::memory_order_relaxed);
+	m_bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pops the most recently pushed job (Owner thread only). Returns nullptr if empty
+//
+Job* JobDeque::Pop()
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if(top > bottom)
+	{
+		// Empty, restore the bottom
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_jobs[bottom & JOB_INDEX_MASK].load(std::memory_order_relaxed);
+	if(top == bottom)
+	{
+		// Last job, race against the thieves for it
+		if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Steals the oldest job from the deque (Any thread). Returns nullptr if empty or lost the race
+//
+Job* JobDeque::Steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+	if(top >= bottom)
+	{
+		return nullptr;
+	}
+
+	Job* job = m_jobs[top & JOB_INDEX_MASK].load(std::memory_order_relaxed);
+	if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr; // Another thread got it first
+	}
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the deque looks non empty (Any thread)
+//
+bool JobDeque::HasJobs() const
+{
+	return m_bottom.load(std::memory_order_seq_cst) > m_top.load(std::memory_order_seq_cst);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor. The calling thread becomes worker 0
+//
+JobSystem::JobSystem(int workerCount)
+{
+	if(workerCount <= 0)
+	{
+		workerCount = ThreadGetCoreCount();
+	}
+
+	m_workerCount = workerCount;
+	m_workers = (JobWorker*) AlignedAllocate(sizeof(JobWorker) * m_workerCount, alignof(JobWorker));
+	for(int index = 0; index < m_workerCount; ++index)
+	{
+		new (&m_workers[index]) JobWorker();
+	}
+
+	t_workerIndex = 0;
+	for(int index = 0; index < m_workerCount; ++index)
+	{
+		m_workers[index].jobSystem = this;
+		m_workers[index].index = index;
+		m_workers[index].randomSeed = (uint32_t) (index + 1) * 2654435761u;
+	}
+
+	// Worker n is pinned to core n, so the workers never compete with the main thread's core
+	int coreCount = ThreadGetCoreCount();
+	for(int index = 1; index < m_workerCount; ++index)
+	{
+		m_workers[index].thread = ThreadCreate("Job Worker", WorkerThreadEntry, &m_workers[index]);
+
+		int core = (ENGINE_MAIN_THREAD_CORE + index) % coreCount;
+		if(coreCount > 1 && core < 64)
+		{
+			ThreadSetAffinity(m_workers[index].thread, (uint64_t) 1 << core);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+JobSystem::~JobSystem()
+{
+	m_isRunning = false;
+	WakeWorkers(true);
+
+	for(int index = 1; index < m_workerCount; ++index)
+	{
+		ThreadJoin(m_workers[index].thread);
+		m_workers[index].thread = nullptr;
+	}
+
+	for(int index = 0; index < m_workerCount; ++index)
+	{
+		m_workers[index].~JobWorker();
+	}
+	AlignedFree(m_workers);
+	m_workers = nullptr;
+
+	t_workerIndex = -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the worker that belongs to the calling thread, nullptr if not a job worker
+//
+JobWorker* JobSystem::GetCurrentWorker() const
+{
+	if(t_workerIndex < 0)
+	{
+		return nullptr;
+	}
+
+	return &m_workers[t_workerIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a job that calls back with the user data pointer
+//
+JobHandle JobSystem::CreateJob(JobCb cb, void* userData)
+{
+	Job* job = AllocateJob();
+	job->callback = cb;
+	job->userData = userData;
+	job->parent = nullptr;
+	job->unfinishedJobs.store(1, std::memory_order_relaxed);
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a job and copies the data into the job. The callback receives the copy
+//
+JobHandle JobSystem::CreateJob(JobCb cb, const void* data, size_t dataSize)
+{
+	GUARANTEE_OR_DIE(dataSize <= JOB_MAX_DATA_SIZE, "Job data is too big, pass a pointer instead");
+
+	Job* job = CreateJob(cb, nullptr);
+	memcpy(job->data, data, dataSize);
+	job->userData = job->data;
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a job as a child of parent. The parent is not finished until all its children are
+//
+JobHandle JobSystem::CreateChildJob(JobHandle parent, JobCb cb, void* userData)
+{
+	parent->unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+	Job* job = CreateJob(cb, userData);
+	job->parent = parent;
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a child job and copies the data into the job
+//
+JobHandle JobSystem::CreateChildJob(JobHandle parent, JobCb cb, const void* data, size_t dataSize)
+{
+	parent->unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+	Job* job = CreateJob(cb, data, dataSize);
+	job->parent = parent;
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Queues the job on the calling worker's deque. Runs it inline if the deque is full
+//
+void JobSystem::Run(JobHandle job)
+{
+	JobWorker* worker = GetCurrentWorker();
+	GUARANTEE_OR_DIE(worker != nullptr, "Jobs can only be run from job worker threads");
+
+	if(!worker->deque.Push(job))
+	{
+		Execute(job);
+		return;
+	}
+
+	WakeWorkers(false);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Blocks until the job and all its children are finished. Executes other jobs while waiting
+//
+void JobSystem::Wait(JobHandle job)
+{
+	while(!IsFinished(job))
+	{
+		if(!ExecuteNextJob())
+		{
+			ThreadYield();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the job and all its children have finished
+//
+bool JobSystem::IsFinished(JobHandle job) const
+{
+	return job->unfinishedJobs.load(std::memory_order_acquire) == 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs one job if there is one available. Returns true if a job was executed
+//
+bool JobSystem::ExecuteNextJob()
+{
+	Job* job = GetNextJob();
+	if(job == nullptr)
+	{
+		return false;
+	}
+
+	Execute(job);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pops from the local deque first, then tries to steal from a random worker
+//
+Job* JobSystem::GetNextJob()
+{
+	JobWorker* worker = GetCurrentWorker();
+	if(worker != nullptr)
+	{
+		Job* job = worker->deque.Pop();
+		if(job != nullptr)
+		{
+			return job;
+		}
+	}
+
+	if(m_workerCount <= 1 && worker != nullptr)
+	{
+		return nullptr; // Nobody to steal from
+	}
+
+	// xorshift32 to pick a victim
+	uint32_t seed = worker ? worker->randomSeed : (uint32_t) ThreadGetCurrentID() | 1u;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	if(worker != nullptr)
+	{
+		worker->randomSeed = seed;
+	}
+
+	int startIndex = (int) (seed % (uint32_t) m_workerCount);
+	for(int offset = 0; offset < m_workerCount; ++offset)
+	{
+		JobWorker* victim = &m_workers[(startIndex + offset) % m_workerCount];
+		if(victim == worker)
+		{
+			continue;
+		}
+
+		Job* job = victim->deque.Steal();
+		if(job != nullptr)
+		{
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs the job callback and marks it finished. Jobs without a callback only group children
+//
+void JobSystem::Execute(Job* job)
+{
+	if(job->callback != nullptr)
+	{
+		job->callback(job->userData);
+	}
+
+	Finish(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Decrements the unfinished count and propagates completion to the parent
+//
+void JobSystem::Finish(Job* job)
+{
+	// Read the parent first, once the count hits zero the job slot can be reused
+	Job* parent = job->parent;
+
+	int unfinished = job->unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) - 1;
+	if(unfinished == 0 && parent != nullptr)
+	{
+		Finish(parent);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the next job from the calling worker's pool. Pools are rings, so a job handle stays
+// valid until JOB_MAX_JOBS_PER_WORKER more jobs have been created on the same thread
+//
+Job* JobSystem::AllocateJob()
+{
+	JobWorker* worker = GetCurrentWorker();
+	GUARANTEE_OR_DIE(worker != nullptr, "Jobs can only be created from job worker threads");
+
+	uint32_t index = worker->allocatedJobs++;
+	Job* job = &worker->jobPool[index & JOB_INDEX_MASK];
+
+	GUARANTEE_OR_DIE(index < JOB_MAX_JOBS_PER_WORKER || IsFinished(job), "Job pool wrapped onto an unfinished job");
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Wakes sleeping workers if there are any. Cheap when every worker is busy
+//
+void JobSystem::WakeWorkers(bool wakeAll)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(m_sleepingWorkers.load(std::memory_order_seq_cst) == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_wakeLock);
+	if(wakeAll)
+	{
+		m_wakeCondition.notify_all();
+	}
+	else
+	{
+		m_wakeCondition.notify_one();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if any worker has queued jobs
+//
+bool JobSystem::HasQueuedJobs() const
+{
+	for(int index = 0; index < m_workerCount; ++index)
+	{
+		if(m_workers[index].deque.HasJobs())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Puts the calling worker to sleep until a job is queued or the system shuts down
+//
+void JobSystem::WaitForJobs()
+{
+	std::unique_lock<std::mutex> lock(m_wakeLock);
+	m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+	// Checked under the lock, Run() either sees us sleeping and notifies or we see its job. A job
+	// stolen before we wake just sends us back to spinning
+	m_wakeCondition.wait(lock, [this]() { return !m_isRunning || HasQueuedJobs(); });
+
+	m_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the job system instance
+//
+STATIC JobSystem* JobSystem::CreateInstance(int workerCount /*= 0 */)
+{
+	if(!g_jobSystem)
+	{
+		g_jobSystem = new JobSystem(workerCount);
+	}
+
+	return g_jobSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the job system instance
+//
+STATIC JobSystem* JobSystem::GetInstance()
+{
+	return g_jobSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the job system instance
+//
+STATIC void JobSystem::DestroyInstance()
+{
+	delete g_jobSystem;
+	g_jobSystem = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Worker thread loop. Executes jobs until the system shuts down
+//
+STATIC void JobSystem::WorkerThreadEntry(void* userData)
+{
+	JobWorker* worker = (JobWorker*) userData;
+	JobSystem* jobSystem = worker->jobSystem;
+	t_workerIndex = worker->index;
+
+	int idleCount = 0;
+	while(jobSystem->IsRunning())
+	{
+		if(jobSystem->ExecuteNextJob())
+		{
+			idleCount = 0;
+			continue;
+		}
+
+		idleCount++;
+		if(idleCount < JOB_IDLE_SPIN_COUNT)
+		{
+			ThreadYield();
+		}
+		else
+		{
+			jobSystem->WaitForJobs();
+		}
+	}
+
+	t_workerIndex = -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts up the job system, must be called from the main thread
+//
+void JobSystemStartup(int workerCount /*= 0 */)
+{
+	JobSystem::CreateInstance(workerCount);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Shuts down the job system and joins the worker threads
+//
+void JobSystemShutdown()
+{
+	JobSystem::DestroyInstance();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a job that calls back with the user data
+//
+JobHandle JobCreate(JobCb cb, void* userData /*= nullptr */)
+{
+	return g_jobSystem->CreateJob(cb, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a job with a copy of the data
+//
+JobHandle JobCreateWithData(JobCb cb, const void* data, size_t dataSize)
+{
+	return g_jobSystem->CreateJob(cb, data, dataSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a child job of parent
+//
+JobHandle JobCreateChild(JobHandle parent, JobCb cb, void* userData /*= nullptr */)
+{
+	return g_jobSystem->CreateChildJob(parent, cb, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a child job of parent with a copy of the data
+//
+JobHandle JobCreateChildWithData(JobHandle parent, JobCb cb, const void* data, size_t dataSize)
+{
+	return g_jobSystem->CreateChildJob(parent, cb, data, dataSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Queues the job for execution
+//
+void JobRun(JobHandle job)
+{
+	g_jobSystem->Run(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Waits for the job and its children to finish
+//
+void JobWait(JobHandle job)
+{
+	g_jobSystem->Wait(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the job and its children are finished
+//
+bool JobIsFinished(JobHandle job)
+{
+	return g_jobSystem->IsFinished(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of workers including the main thread
+//
+int JobGetWorkerCount()
+{
+	return g_jobSystem->GetWorkerCount();
+}
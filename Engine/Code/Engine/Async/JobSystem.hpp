@@ -0,0 +1,137 @@
+#pragma once
+#pragma warning (disable:4324) // Padding from alignas is wanted
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include "Engine/Core/EngineConfig.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class JobSystem;
+struct ThreadHandleType;
+typedef ThreadHandleType* ThreadHandle;
+
+//-----------------------------------------------------------------------------------------------
+// Types
+
+// Job callback, userData is either the pointer passed in or the job's own copy of the data
+typedef void (*JobCb)( void* userData );
+
+//-----------------------------------------------------------------------------------------------
+// Padded to a cache line so that neighbouring jobs in the pool never share one
+struct alignas(64) Job
+{
+	JobCb				callback;
+	void*				userData;
+	Job*				parent;
+	std::atomic<int>	unfinishedJobs; // Self + children that have not completed yet
+	unsigned char		data[JOB_MAX_DATA_SIZE]; // Inline storage for small job payloads
+};
+
+typedef Job* JobHandle;
+
+//-----------------------------------------------------------------------------------------------
+// Chase-Lev work stealing deque. The owner pushes/pops from the bottom, thieves steal from the top
+class JobDeque
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	JobDeque(){}
+	~JobDeque(){}
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	bool	Push( Job* job );	// Owner thread only. Returns false if the deque is full
+	Job*	Pop();				// Owner thread only
+	Job*	Steal();			// Any thread
+	bool	HasJobs() const;	// Any thread
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	alignas(64) std::atomic<int64_t>	m_top{0};
+	alignas(64) std::atomic<int64_t>	m_bottom{0};
+	alignas(64) std::atomic<Job*>		m_jobs[JOB_MAX_JOBS_PER_WORKER];
+};
+
+//-----------------------------------------------------------------------------------------------
+// Per worker state. Worker 0 is always the thread that started the job system (main thread).
+// Allocated with AlignedAllocate, the deque and pool rely on the cache line alignment
+struct JobWorker
+{
+	JobDeque		deque;
+	Job				jobPool[JOB_MAX_JOBS_PER_WORKER];
+	JobSystem*		jobSystem = nullptr;
+	int				index = 0;
+	uint32_t		allocatedJobs = 0;
+	uint32_t		randomSeed = 0;
+	ThreadHandle	thread = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+class JobSystem
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	JobSystem( int workerCount );
+	~JobSystem();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int			GetWorkerCount() const { return m_workerCount; }
+			bool		IsRunning() const { return m_isRunning; }
+			JobWorker*	GetCurrentWorker() const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			JobHandle	CreateJob( JobCb cb, void* userData );
+			JobHandle	CreateJob( JobCb cb, const void* data, size_t dataSize );
+			JobHandle	CreateChildJob( JobHandle parent, JobCb cb, void* userData );
+			JobHandle	CreateChildJob( JobHandle parent, JobCb cb, const void* data, size_t dataSize );
+			void		Run( JobHandle job );
+			void		Wait( JobHandle job );
+			bool		IsFinished( JobHandle job ) const;
+			bool		ExecuteNextJob();
+			Job*		GetNextJob();
+			void		Execute( Job* job );
+			void		Finish( Job* job );
+			Job*		AllocateJob();
+			void		WakeWorkers( bool wakeAll );
+			bool		HasQueuedJobs() const;
+			void		WaitForJobs();
+
+	//-----------------------------------------------------------------------------------------------
+	// Static methods
+	static	JobSystem*	CreateInstance( int workerCount = 0 );
+	static	JobSystem*	GetInstance();
+	static	void		DestroyInstance();
+	static	void		WorkerThreadEntry( void* userData );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			std::atomic<bool>	m_isRunning{true};
+			int					m_workerCount = 0;
+			JobWorker*			m_workers = nullptr;
+			std::atomic<int>	m_sleepingWorkers{0};
+			std::mutex			m_wakeLock;
+			std::condition_variable	m_wakeCondition;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+
+// System functions
+void		JobSystemStartup( int workerCount = 0 ); // 0 means one worker per core
+void		JobSystemShutdown();
+
+// Job helpers
+JobHandle	JobCreate( JobCb cb, void* userData = nullptr ); // Null callback makes an empty parent job
+JobHandle	JobCreateWithData( JobCb cb, const void* data, size_t dataSize ); // Data is copied into the job
+JobHandle	JobCreateChild( JobHandle parent, JobCb cb, void* userData = nullptr );
+JobHandle	JobCreateChildWithData( JobHandle parent, JobCb cb, const void* data, size_t dataSize );
+void		JobRun( JobHandle job );
+void		JobWait( JobHandle job ); // Helps with other jobs while waiting
+bool		JobIsFinished( JobHandle job );
+int			JobGetWorkerCount();
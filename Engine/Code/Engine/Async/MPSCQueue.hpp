@@ -0,0 +1,134 @@
+#pragma once
+#pragma warning (disable:4324) // Padding from alignas is wanted
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+#include "Engine/Core/AlignedAllocation.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Bounded lock-free multi producer single consumer queue (Vyukov). Nothing is allocated after
+// construction. Enqueue can be called from any thread, Dequeue/DequeueAll must only be called by
+// one thread at a time. CAPACITY must be a power of two
+//
+// Each cell's sequence number says whether it is free for the producer at that position or full
+// for the consumer. A producer that gets preempted between claiming its cell and publishing it
+// hides the cells behind it until it resumes, the consumer just sees the queue as empty for that
+// moment
+template<typename T, size_t CAPACITY>
+class MPSCQueue
+{
+	static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "MPSCQueue capacity must be a power of two");
+
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	MPSCQueue()
+	{
+		for(size_t index = 0; index < CAPACITY; ++index)
+		{
+			m_cells[index].sequence.store(index, std::memory_order_relaxed);
+		}
+	}
+
+	~MPSCQueue(){}
+
+	MPSCQueue( const MPSCQueue& ) = delete;
+	MPSCQueue& operator=( const MPSCQueue& ) = delete;
+	ALIGNED_NEW_AND_DELETE(MPSCQueue)
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	size_t	GetCapacity() const { return CAPACITY; }
+	bool	IsEmpty() const { return m_cells[m_tail & MASK].sequence.load(std::memory_order_acquire) != m_tail + 1; } // Consumer only
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	bool Enqueue( const T& value ) // Returns false if full
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+
+		while(true)
+		{
+			cell = &m_cells[head & MASK];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t difference = (ptrdiff_t) sequence - (ptrdiff_t) head;
+
+			if(difference == 0)
+			{
+				// Cell is free at this position, claiming it is the only contended step
+				if(m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if(difference < 0)
+			{
+				// Consumer hasn't freed the cell from the last lap yet
+				return false;
+			}
+			else
+			{
+				// Another producer claimed it first
+				head = m_head.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->value = value;
+		cell->sequence.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool Dequeue( T* outValue ) // Returns true if it succeeds
+	{
+		Cell& cell = m_cells[m_tail & MASK];
+		if(cell.sequence.load(std::memory_order_acquire) != m_tail + 1)
+		{
+			return false;
+		}
+
+		*outValue = std::move(cell.value);
+
+		// Frees the cell for the producers' next lap
+		cell.sequence.store(m_tail + CAPACITY, std::memory_order_release);
+		m_tail++;
+
+		return true;
+	}
+
+	size_t DequeueAll( std::vector<T>& outValues ) // Appends everything queued, returns the count
+	{
+		size_t count = 0;
+		T value;
+
+		while(Dequeue(&value))
+		{
+			outValues.push_back(std::move(value));
+			count++;
+		}
+
+		return count;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Types
+	struct Cell
+	{
+		std::atomic<size_t>	sequence{0};
+		T					value = T();
+	};
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	static const size_t				MASK = CAPACITY - 1;
+
+	alignas(64) std::atomic<size_t>	m_head{0};	// Producers
+	alignas(64) size_t				m_tail = 0;	// Consumer
+	alignas(64) Cell				m_cells[CAPACITY];
+};
@@ -0,0 +1,137 @@
+#pragma once
+#pragma warning (disable:4324) // Padding from alignas is wanted
+#include <atomic>
+#include <stddef.h>
+#include "Engine/Core/AlignedAllocation.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Fixed capacity single producer single consumer ring buffer. Every call is wait-free and nothing
+// is allocated after construction. CAPACITY must be a power of two
+//
+// Head and tail live on separate cache lines, and each side keeps a private copy of the other
+// side's index so it only touches the shared line when the buffer looks full/empty
+template<typename T, size_t CAPACITY>
+class SPSCRingBuffer
+{
+	static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "SPSCRingBuffer capacity must be a power of two");
+
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	SPSCRingBuffer(){}
+	~SPSCRingBuffer(){}
+
+	SPSCRingBuffer( const SPSCRingBuffer& ) = delete;
+	SPSCRingBuffer& operator=( const SPSCRingBuffer& ) = delete;
+	ALIGNED_NEW_AND_DELETE(SPSCRingBuffer)
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	size_t	GetCapacity() const { return CAPACITY; }
+	size_t	GetSize() const { size_t tail = m_tail.load(std::memory_order_acquire); return m_head.load(std::memory_order_acquire) - tail; } // Approximate from a third thread
+	bool	IsEmpty() const { return GetSize() == 0; }
+	bool	IsFull() const { return GetSize() == CAPACITY; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+
+	// Producer thread only
+	bool Push( const T& value ) // Returns false if full
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+
+		if(head - m_cachedTail == CAPACITY)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if(head - m_cachedTail == CAPACITY)
+			{
+				return false;
+			}
+		}
+
+		m_data[head & MASK] = value;
+		m_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	size_t PushBatch( const T* values, size_t count ) // Returns how many were pushed
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		size_t freeSlots = CAPACITY - (head - m_cachedTail);
+
+		if(freeSlots < count)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			freeSlots = CAPACITY - (head - m_cachedTail);
+		}
+
+		count = count < freeSlots ? count : freeSlots;
+		for(size_t index = 0; index < count; ++index)
+		{
+			m_data[(head + index) & MASK] = values[index];
+		}
+
+		// Publish the whole batch with one store
+		m_head.store(head + count, std::memory_order_release);
+
+		return count;
+	}
+
+	// Consumer thread only
+	bool Pop( T* outValue ) // Returns false if empty
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		if(tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if(tail == m_cachedHead)
+			{
+				return false;
+			}
+		}
+
+		*outValue = m_data[tail & MASK];
+		m_tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	size_t PopBatch( T* outValues, size_t maxCount ) // Returns how many were popped
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		size_t available = m_cachedHead - tail;
+
+		if(available < maxCount)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			available = m_cachedHead - tail;
+		}
+
+		size_t count = maxCount < available ? maxCount : available;
+		for(size_t index = 0; index < count; ++index)
+		{
+			outValues[index] = m_data[(tail + index) & MASK];
+		}
+
+		// Hand the slots back to the producer with one store
+		m_tail.store(tail + count, std::memory_order_release);
+
+		return count;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	static const size_t				MASK = CAPACITY - 1;
+
+	alignas(64) std::atomic<size_t>	m_head{0};			// Written by the producer
+				size_t				m_cachedTail = 0;	// Producer's copy of m_tail
+	alignas(64) std::atomic<size_t>	m_tail{0};			// Written by the consumer
+				size_t				m_cachedHead = 0;	// Consumer's copy of m_head
+	alignas(64) T					m_data[CAPACITY];
+};
@@ -0,0 +1,69 @@
+#include "Engine/Async/Signal.hpp"
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <chrono>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Registers the calling thread as a waiter and returns the epoch to wait on
+//
+uint64_t Signal::PrepareWait()
+{
+	m_waiters.fetch_add(1, std::memory_order_seq_cst);
+	std::atomic_thread_fence(std::memory_order_seq_cst); // Our work check must not move above the registration
+
+	return m_epoch.load(std::memory_order_seq_cst);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Unregisters a waiter that found work after PrepareWait
+//
+void Signal::CancelWait()
+{
+	m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sleeps until Notify is called after the epoch was read, or the timeout passes
+//
+bool Signal::Wait(uint64_t epoch, unsigned int timeoutMs /*= SIGNAL_WAIT_FOREVER */)
+{
+	bool wasNotified = true;
+
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		auto hasChanged = [this, epoch]() { return m_epoch.load(std::memory_order_relaxed) != epoch; };
+
+		if(timeoutMs == SIGNAL_WAIT_FOREVER)
+		{
+			m_condition.wait(lock, hasChanged);
+		}
+		else
+		{
+			wasNotified = m_condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), hasChanged);
+		}
+	}
+
+	m_waiters.fetch_sub(1, std::memory_order_relaxed);
+	return wasNotified;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Wakes every waiter. Only touches the lock if someone is waiting
+//
+void Signal::Notify()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in PrepareWait
+
+	if(m_waiters.load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_epoch.fetch_add(1, std::memory_order_release);
+	}
+
+	m_condition.notify_all();
+}
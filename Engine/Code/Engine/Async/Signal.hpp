@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define SIGNAL_WAIT_FOREVER		0xFFFFFFFFu
+
+//-----------------------------------------------------------------------------------------------
+// Wait/notify primitive (event count). Notify costs one load when nobody is waiting, so producers
+// can call it for every item they publish. Waiters must announce themselves before checking for
+// work so a notify can never slip in between the check and the sleep:
+//
+//		uint64_t epoch = signal.PrepareWait();
+//		if(HasWork())	signal.CancelWait();
+//		else			signal.Wait(epoch, timeoutMs);
+//
+class Signal
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	Signal(){}
+	~Signal(){}
+
+	Signal( const Signal& ) = delete;
+	Signal& operator=( const Signal& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	uint64_t	PrepareWait();
+	void		CancelWait();
+	bool		Wait( uint64_t epoch, unsigned int timeoutMs = SIGNAL_WAIT_FOREVER ); // Returns false on timeout
+	void		Notify(); // Wakes every waiter
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::atomic<uint64_t>	m_epoch{0};
+	std::atomic<int>		m_waiters{0};
+	std::mutex				m_lock;
+	std::condition_variable	m_condition;
+};
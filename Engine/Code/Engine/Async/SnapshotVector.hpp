@@ -0,0 +1,119 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+#include "Engine/Async/Spinlock.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Read-mostly vector (RCU style). Readers grab an immutable snapshot with one atomic load and never
+// lock. Writers copy the current snapshot, modify the copy and publish it
+//
+// Replaced snapshots are kept until Reclaim is called, which the owner must only do when no reader
+// can still be holding an old snapshot (a quiescent point, e.g. the end of the reader's loop)
+template<typename T>
+class SnapshotVector
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	SnapshotVector() : m_snapshot(new std::vector<T>()) {}
+	explicit SnapshotVector( const char* lockName ) : m_writeLock(lockName), m_snapshot(new std::vector<T>()) {} // Named locks report contention to the profiler
+	~SnapshotVector()
+	{
+		Reclaim();
+		delete m_snapshot.load(std::memory_order_relaxed);
+	}
+
+	SnapshotVector( const SnapshotVector& ) = delete;
+	SnapshotVector& operator=( const SnapshotVector& ) = delete;
+	ALIGNED_NEW_AND_DELETE(SnapshotVector) // Its lock is cache line aligned
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	const std::vector<T>*	GetSnapshot() const { return m_snapshot.load(std::memory_order_acquire); } // Valid until the next Reclaim
+	size_t					Size() const { return GetSnapshot()->size(); }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+
+	// Read methods
+	size_t Find( const T& value ) const
+	{
+		const std::vector<T>& data = *GetSnapshot();
+		for(size_t index = 0; index < data.size(); index++)
+		{
+			if(data[index] == value)
+			{
+				return index;
+			}
+		}
+
+		return UINT32_MAX;
+	}
+
+	// Write methods. Each one publishes a new snapshot
+	template<typename Modifier>
+	void Modify( Modifier modifier ) // modifier( std::vector<T>& copy )
+	{
+		m_writeLock.Enter();
+
+		std::vector<T>* copy = new std::vector<T>(*m_snapshot.load(std::memory_order_relaxed));
+		modifier(*copy);
+
+		m_retired.push_back(m_snapshot.exchange(copy, std::memory_order_acq_rel));
+
+		m_writeLock.Leave();
+	}
+
+	void PushBack( const T& value )
+	{
+		Modify([&value](std::vector<T>& data) { data.push_back(value); });
+	}
+
+	void Erase( size_t index )
+	{
+		Modify([index](std::vector<T>& data) { data.erase(data.begin() + index); });
+	}
+
+	void Erase( const T& value )
+	{
+		Modify([&value](std::vector<T>& data)
+		{
+			typename std::vector<T>::iterator found = std::find(data.begin(), data.end(), value);
+			if(found != data.end())
+			{
+				data.erase(found);
+			}
+		});
+	}
+
+	void Clear()
+	{
+		Modify([](std::vector<T>& data) { data.clear(); });
+	}
+
+	// Frees the snapshots replaced since the last call
+	void Reclaim()
+	{
+		m_writeLock.Enter();
+
+		for(const std::vector<T>* retired : m_retired)
+		{
+			delete retired;
+		}
+		m_retired.clear();
+
+		m_writeLock.Leave();
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	Spinlock							m_writeLock; // Writers only
+	std::atomic<const std::vector<T>*>	m_snapshot;
+	std::vector<const std::vector<T>*>	m_retired;
+};
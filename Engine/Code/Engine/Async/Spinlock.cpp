@@ -6,12 +6,177 @@
 
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
-
+#include "Engine/Async/Thread.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
 // Standard Includes
+#include <algorithm>
+#include <mutex>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define SPINLOCK_HAS_PAUSE
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define SPINLOCK_MAX_PAUSES			64	// Backoff doubles up to this many pauses per check
+#define SPINLOCK_SPINS_BEFORE_YIELD	16	// Backoff rounds before giving the core away
 
 //-----------------------------------------------------------------------------------------------
+// Types
+struct SpinlockStatsRegistry
+{
+	std::mutex						lock; // Only taken when named locks are created or destroyed
+	std::vector<SpinlockStats*>		stats;
+};
 
+//-----------------------------------------------------------------------------------------------
+// Returns the registry of named locks. Created on first use, so named locks that are globals of
+// other files can register during static initialization, and it outlives them at exit
+//
+static SpinlockStatsRegistry& GetStatsRegistry()
+{
+	static SpinlockStatsRegistry s_statsRegistry;
+	return s_statsRegistry;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Tells the core we are spinning, lowers power use and frees the pipeline for the other hyper thread
+//
+static inline void CpuPause()
+{
+#if defined(SPINLOCK_HAS_PAUSE)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
 
+//-----------------------------------------------------------------------------------------------
+// Returns a cheap timestamp for measuring spin time
+//
+static inline uint64_t GetSpinTimestamp()
+{
+#if defined(SPINLOCK_HAS_PAUSE)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor. Registers the lock's stats so they can be shown in the profiler
+//
+Spinlock::Spinlock(const char* name)
+{
+	m_stats = new SpinlockStats();
+	m_stats->name = name;
+
+	SpinlockStatsRegistry& registry = GetStatsRegistry();
+	std::lock_guard<std::mutex> registryLock(registry.lock);
+	registry.stats.push_back(m_stats);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+Spinlock::~Spinlock()
+{
+	if(m_stats != nullptr)
+	{
+		SpinlockStatsRegistry& registry = GetStatsRegistry();
+		std::lock_guard<std::mutex> registryLock(registry.lock);
+		registry.stats.erase(std::remove(registry.stats.begin(), registry.stats.end(), m_stats), registry.stats.end());
+
+		delete m_stats;
+		m_stats = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Slow path for Enter. Spins on a plain load with exponential pause backoff, then yields
+//
+void Spinlock::EnterContended()
+{
+	uint64_t startTime = GetSpinTimestamp();
+	uint64_t spinCount = 0;
+	int pauseCount = 1;
+	int rounds = 0;
+
+	do
+	{
+		// Wait on a read so the cache line stays shared until the owner releases it
+		while(m_isLocked.load(std::memory_order_relaxed))
+		{
+			if(rounds < SPINLOCK_SPINS_BEFORE_YIELD)
+			{
+				for(int pause = 0; pause < pauseCount; ++pause)
+				{
+					CpuPause();
+				}
+
+				spinCount += pauseCount;
+				pauseCount = std::min(pauseCount * 2, SPINLOCK_MAX_PAUSES);
+				rounds++;
+			}
+			else
+			{
+				// Owner is probably descheduled, let it run
+				ThreadYield();
+				spinCount++;
+			}
+		}
+	}
+	while(m_isLocked.exchange(true, std::memory_order_acquire));
+
+	if(m_stats != nullptr)
+	{
+		uint64_t spinCycles = startTime != 0 ? GetSpinTimestamp() - startTime : spinCount;
+		m_stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+		m_stats->contendedAcquisitions.fetch_add(1, std::memory_order_relaxed);
+		m_stats->spinCycles.fetch_add(spinCycles, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the stats of every named lock alive. Copied under the registry lock, so a lock destroyed
+// right after can't take them with it
+//
+void SpinlockGetAllStats(std::vector<SpinlockStatsSnapshot>& outStats)
+{
+	SpinlockStatsRegistry& registry = GetStatsRegistry();
+	std::lock_guard<std::mutex> registryLock(registry.lock);
+
+	outStats.resize(registry.stats.size());
+	for(size_t statsIndex = 0; statsIndex < registry.stats.size(); ++statsIndex)
+	{
+		const SpinlockStats* stats = registry.stats[statsIndex];
+		SpinlockStatsSnapshot& snapshot = outStats[statsIndex];
+
+		snapshot.name = stats->name != nullptr ? stats->name : "";
+		snapshot.acquisitions = stats->acquisitions.load(std::memory_order_relaxed);
+		snapshot.contendedAcquisitions = stats->contendedAcquisitions.load(std::memory_order_relaxed);
+		snapshot.spinCycles = stats->spinCycles.load(std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Zeroes the counters of every named lock
+//
+void SpinlockResetAllStats()
+{
+	SpinlockStatsRegistry& registry = GetStatsRegistry();
+	std::lock_guard<std::mutex> registryLock(registry.lock);
+	for(SpinlockStats* stats : registry.stats)
+	{
+		stats->acquisitions = 0;
+		stats->contendedAcquisitions = 0;
+		stats->spinCycles = 0;
+	}
+}
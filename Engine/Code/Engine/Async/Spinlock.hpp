@@ -1,30 +1,109 @@
 #pragma once
-#include <mutex>
+#pragma warning (disable:4324) // Padding from alignas is wanted
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Engine/Core/AlignedAllocation.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 
 
 //-----------------------------------------------------------------------------------------------
-class Spinlock
+// Contention counters, only kept for locks that are given a name
+struct SpinlockStats
+{
+	const char*				name = nullptr;
+	std::atomic<uint64_t>	acquisitions{0};
+	std::atomic<uint64_t>	contendedAcquisitions{0};
+	std::atomic<uint64_t>	spinCycles{0}; // Cycles spent waiting (spin iterations where there is no cycle counter)
+};
+
+//-----------------------------------------------------------------------------------------------
+// Copy of a named lock's stats, still valid after the lock is destroyed
+struct SpinlockStatsSnapshot
+{
+	std::string	name;
+	uint64_t	acquisitions = 0;
+	uint64_t	contendedAcquisitions = 0;
+	uint64_t	spinCycles = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Test and test-and-set spinlock. Padded to a cache line so neighbouring locks never false share
+class alignas(64) Spinlock
 {
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	Spinlock(){}
-	~Spinlock(){}
-	
+	explicit Spinlock( const char* name ); // Named locks keep stats and show up in the profiler
+	~Spinlock();
+	ALIGNED_NEW_AND_DELETE(Spinlock)
+
+	Spinlock( const Spinlock& ) = delete;
+	Spinlock& operator=( const Spinlock& ) = delete;
+
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-	
+	const	SpinlockStats*	GetStats() const { return m_stats; }
+
 	//-----------------------------------------------------------------------------------------------
 	// Methods
-	void Enter() { m_lock.lock(); } // Blocking call
-	bool TryEnter() { return m_lock.try_lock(); }
-	void Leave() { m_lock.unlock(); } // Must be called if entered
-	
+	inline	void			Enter(); // Blocking call
+	inline	bool			TryEnter();
+	inline	void			Leave(); // Must be called if entered
+			void			EnterContended();
+
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	std::mutex m_lock;
+	std::atomic<bool>	m_isLocked{false};
+	SpinlockStats*		m_stats = nullptr;
 };
 
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void SpinlockGetAllStats( std::vector<SpinlockStatsSnapshot>& outStats );
+void SpinlockResetAllStats();
+
+//-----------------------------------------------------------------------------------------------
+// Acquires the lock, spinning with backoff if another thread holds it
+//
+inline void Spinlock::Enter()
+{
+	if(m_isLocked.exchange(true, std::memory_order_acquire))
+	{
+		EnterContended();
+	}
+	else if(m_stats != nullptr)
+	{
+		m_stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Tries to acquire the lock without waiting. Returns true if it was acquired
+//
+inline bool Spinlock::TryEnter()
+{
+	// Plain load first so a held lock's cache line is not stolen by the exchange
+	if(m_isLocked.load(std::memory_order_relaxed) || m_isLocked.exchange(true, std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	if(m_stats != nullptr)
+	{
+		m_stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Releases the lock
+//
+inline void Spinlock::Leave()
+{
+	m_isLocked.store(false, std::memory_order_release);
+}
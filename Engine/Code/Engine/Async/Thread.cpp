@@ -11,15 +11,34 @@
 
 //-----------------------------------------------------------------------------------------------
 // Standard Includes
-#include "Engine/Core/Platform/Win32.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include <thread>
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
 // Defines
-#define MS_VC_EXCEPTION				(0x406d1388)
 #define DEFAULT_THREAD_STACK_SIZE	(1 * MB)
 
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static thread_local const char* t_threadName = nullptr;
+
+//-----------------------------------------------------------------------------------------------
+struct ThreadStartArgs
+{
+	const char* name;
+	ThreadCb	function;
+	void*		userData;
+};
+
+#if defined(_WIN32)
+//-----------------------------------------------------------------------------------------------
+// Win32 Implementation
+//-----------------------------------------------------------------------------------------------
+#include "Engine/Core/Platform/Win32.hpp"
+
+#define MS_VC_EXCEPTION				(0x406d1388)
+
 //-----------------------------------------------------------------------------------------------
 #pragma pack(push, 8)
 struct THREADNAME_INFO // Structure packed 8 bytes to ensure usage with winapi call
@@ -31,14 +50,6 @@ struct THREADNAME_INFO // Structure packed 8 bytes to ensure usage with winapi c
 };
 #pragma pack(pop)
 
-//-----------------------------------------------------------------------------------------------
-struct ThreadStartArgs
-{
-	const char* name;
-	ThreadCb	function;
-	void*		userData;
-};
-
 //-----------------------------------------------------------------------------------------------
 // Thread start routine used by the thread creation call
 //
@@ -55,7 +66,7 @@ static DWORD WINAPI ThreadEntryPoint( void* arg )
 	// Free the initial memory used
 	delete args;
 
-	// Call the callback with the data 
+	// Call the callback with the data
 	cb(data);
 
 	return 0;
@@ -83,22 +94,6 @@ ThreadHandle ThreadCreate(const char* name, ThreadCb cb, size_t stackSize /*= 0*
 	return handle;
 }
 
-//-----------------------------------------------------------------------------------------------
-// Creates the Thread and returns the handle
-//
-ThreadHandle ThreadCreate(const char* name, ThreadCb cb, void* userData /*= nullptr */)
-{
-	return ThreadCreate(name, cb, 0, userData);
-}
-
-//-----------------------------------------------------------------------------------------------
-// Creates the Thread and returns the handle
-//
-ThreadHandle ThreadCreate(ThreadCb cb, void* userData /*= nullptr */)
-{
-	return ThreadCreate(nullptr, cb, 0, userData);
-}
-
 //-----------------------------------------------------------------------------------------------
 // Causes a blocking wait until the thread is done then closes the handle
 //
@@ -122,31 +117,6 @@ void ThreadDetach(ThreadHandle handle)
 	}
 }
 
-//-----------------------------------------------------------------------------------------------
-// Creates the thread and detaches it
-//
-void ThreadCreateAndDetach(const char* name, ThreadCb cb, size_t stackSize /*= 0*/, void* userData /*= nullptr */)
-{
-	ThreadHandle handle = ThreadCreate(name, cb, stackSize, userData);
-	ThreadDetach(handle);
-}
-
-//-----------------------------------------------------------------------------------------------
-// Creates the thread and detaches it
-//
-void ThreadCreateAndDetach(const char* name, ThreadCb cb, void* userData /*= nullptr */)
-{
-	ThreadCreateAndDetach(name, cb, 0, userData);
-}
-
-//-----------------------------------------------------------------------------------------------
-// Creates the thread and detaches it
-//
-void ThreadCreateAndDetach(ThreadCb cb, void* userData /*= nullptr */)
-{
-	ThreadCreateAndDetach(nullptr, cb, 0, userData);
-}
-
 //-----------------------------------------------------------------------------------------------
 // Returns the ID of the current thread
 //
@@ -168,7 +138,7 @@ uintptr_t ThreadGetID(ThreadHandle handle)
 //
 void ThreadSleep(int ms)
 {
-	::Sleep( (DWORD) ms );
+	::Sleep( (DWORD) (ms > 0 ? ms : 0) ); // A negative time would become INFINITE
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -179,6 +149,36 @@ void ThreadYield()
 	::SwitchToThread();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Restricts the thread to the cores in the mask (bit n = core n). nullptr is the calling thread
+//
+bool ThreadSetAffinity(ThreadHandle handle, uint64_t coreMask)
+{
+	HANDLE thread = (handle != nullptr) ? (HANDLE) handle : ::GetCurrentThread();
+	return ::SetThreadAffinityMask(thread, (DWORD_PTR) coreMask) != 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the scheduling priority of the thread. nullptr is the calling thread
+//
+bool ThreadSetPriority(ThreadHandle handle, ThreadPriority priority)
+{
+	HANDLE thread = (handle != nullptr) ? (HANDLE) handle : ::GetCurrentThread();
+
+	int winPriority = THREAD_PRIORITY_NORMAL;
+	switch (priority)
+	{
+	case THREAD_PRIO_LOWEST:	winPriority = THREAD_PRIORITY_LOWEST;			break;
+	case THREAD_PRIO_LOW:		winPriority = THREAD_PRIORITY_BELOW_NORMAL;		break;
+	case THREAD_PRIO_NORMAL:	winPriority = THREAD_PRIORITY_NORMAL;			break;
+	case THREAD_PRIO_HIGH:		winPriority = THREAD_PRIORITY_ABOVE_NORMAL;		break;
+	case THREAD_PRIO_HIGHEST:	winPriority = THREAD_PRIORITY_HIGHEST;			break;
+	default:					return false;
+	}
+
+	return ::SetThreadPriority(thread, winPriority) != 0;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets the name of the thread for debugging in Visual Studio
 //
@@ -189,6 +189,8 @@ void ThreadSetName(const char* name)
 		return;
 	}
 
+	t_threadName = name;
+
 	uintptr_t id = ThreadGetCurrentID();
 	if(id != 0)
 	{
@@ -197,7 +199,7 @@ void ThreadSetName(const char* name)
 		info.name = name;
 		info.thread_id = (DWORD) id;
 		info.flags = 0;
-	
+
 		__try
 		{
 			RaiseException(MS_VC_EXCEPTION, 0, sizeof(info) / sizeof(ULONG_PTR), (ULONG_PTR*) (&info) );
@@ -209,3 +211,313 @@ void ThreadSetName(const char* name)
 		}
 	}
 }
+
+#else
+//-----------------------------------------------------------------------------------------------
+// POSIX Implementation
+//-----------------------------------------------------------------------------------------------
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+
+#define MAX_POSIX_THREAD_NAME		16 // Includes the null terminator
+
+//-----------------------------------------------------------------------------------------------
+struct ThreadHandleType
+{
+	pthread_t thread;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Thread start routine used by the thread creation call
+//
+static void* ThreadEntryPoint( void* arg )
+{
+	// Set the name of the thread for easier debugging
+	ThreadStartArgs* args = (ThreadStartArgs*) arg;
+	ThreadSetName(args->name);
+
+	// Get the data from the passed arguments
+	ThreadCb cb = args->function;
+	void* data = args->userData;
+
+	// Free the initial memory used
+	delete args;
+
+	// Call the callback with the data
+	cb(data);
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the pthread for the handle, nullptr being the calling thread
+//
+static pthread_t GetPThread( ThreadHandle handle )
+{
+	return (handle != nullptr) ? handle->thread : pthread_self();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the Thread and returns the handle
+//
+ThreadHandle ThreadCreate(const char* name, ThreadCb cb, size_t stackSize /*= 0*/, void* userData /*= nullptr */)
+{
+	ThreadStartArgs* args = new ThreadStartArgs();
+	args->name = name;
+	args->function = cb;
+	args->userData = userData;
+
+	// If stack size is not mentioned, default to (1 MB)
+	if(stackSize == 0)
+	{
+		stackSize = DEFAULT_THREAD_STACK_SIZE;
+	}
+
+	if(stackSize < (size_t) PTHREAD_STACK_MIN)
+	{
+		stackSize = (size_t) PTHREAD_STACK_MIN;
+	}
+
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, stackSize);
+
+	ThreadHandle handle = new ThreadHandleType();
+	int errorCode = pthread_create(&handle->thread, &attributes, ThreadEntryPoint, args);
+	pthread_attr_destroy(&attributes);
+
+	if(errorCode != 0)
+	{
+		delete args;
+		delete handle;
+		return nullptr;
+	}
+
+	return handle;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Causes a blocking wait until the thread is done then frees the handle
+//
+void ThreadJoin(ThreadHandle handle)
+{
+	if(handle != nullptr)
+	{
+		pthread_join(handle->thread, nullptr);
+		delete handle;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Detaches the thread from the program and continues until its end
+//
+void ThreadDetach(ThreadHandle handle)
+{
+	if(handle != nullptr)
+	{
+		pthread_detach(handle->thread);
+		delete handle;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the ID of the current thread
+//
+uintptr_t ThreadGetCurrentID()
+{
+	return (uintptr_t) pthread_self();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the ID of the thread specified
+//
+uintptr_t ThreadGetID(ThreadHandle handle)
+{
+	return (uintptr_t) GetPThread(handle);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Puts the current thread to sleep for the specified time in milliseconds
+//
+void ThreadSleep(int ms)
+{
+	ms = ms > 0 ? ms : 0; // nanosleep rejects negative times
+
+	timespec duration;
+	duration.tv_sec = ms / 1000;
+	duration.tv_nsec = (long) (ms % 1000) * 1000000L;
+
+	// Resume the sleep if a signal interrupts it, any other error won't go away by retrying
+	while(nanosleep(&duration, &duration) != 0 && errno == EINTR)
+	{
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches the thread if there are others on the queue
+//
+void ThreadYield()
+{
+	sched_yield();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Restricts the thread to the cores in the mask (bit n = core n). nullptr is the calling thread
+//
+bool ThreadSetAffinity(ThreadHandle handle, uint64_t coreMask)
+{
+#if defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for(int core = 0; core < 64; ++core)
+	{
+		if(coreMask & ((uint64_t) 1 << core))
+		{
+			CPU_SET(core, &cpuSet);
+		}
+	}
+
+	return pthread_setaffinity_np(GetPThread(handle), sizeof(cpuSet), &cpuSet) == 0;
+#else
+	UNUSED(handle);
+	UNUSED(coreMask);
+	return false; // No hard affinity on this platform
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the scheduling priority of the thread. nullptr is the calling thread
+// Raising above normal needs real time scheduling rights, returns false if they are missing
+//
+bool ThreadSetPriority(ThreadHandle handle, ThreadPriority priority)
+{
+	int policy = SCHED_OTHER;
+	sched_param param;
+	memset(&param, 0, sizeof(param));
+
+	switch (priority)
+	{
+#if defined(__linux__)
+	case THREAD_PRIO_LOWEST:	policy = SCHED_IDLE;	break;
+	case THREAD_PRIO_LOW:		policy = SCHED_BATCH;	break;
+#else
+	case THREAD_PRIO_LOWEST:
+	case THREAD_PRIO_LOW:		policy = SCHED_OTHER;	break;
+#endif
+	case THREAD_PRIO_NORMAL:	policy = SCHED_OTHER;	break;
+	case THREAD_PRIO_HIGH:
+		policy = SCHED_RR;
+		param.sched_priority = sched_get_priority_min(SCHED_RR);
+		break;
+	case THREAD_PRIO_HIGHEST:
+		policy = SCHED_RR;
+		param.sched_priority = (sched_get_priority_min(SCHED_RR) + sched_get_priority_max(SCHED_RR)) / 2;
+		break;
+	default:
+		return false;
+	}
+
+	return pthread_setschedparam(GetPThread(handle), policy, &param) == 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the name of the calling thread, shows up in gdb, perf and /proc
+//
+void ThreadSetName(const char* name)
+{
+	if(name == nullptr)
+	{
+		return;
+	}
+
+	t_threadName = name;
+
+	// Names are capped at 15 characters
+	char shortName[MAX_POSIX_THREAD_NAME];
+	strncpy(shortName, name, MAX_POSIX_THREAD_NAME - 1);
+	shortName[MAX_POSIX_THREAD_NAME - 1] = '\0';
+
+#if defined(__APPLE__)
+	pthread_setname_np(shortName);
+#else
+	pthread_setname_np(pthread_self(), shortName);
+#endif
+}
+
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Creates the Thread and returns the handle
+//
+ThreadHandle ThreadCreate(const char* name, ThreadCb cb, void* userData /*= nullptr */)
+{
+	return ThreadCreate(name, cb, 0, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the Thread and returns the handle
+//
+ThreadHandle ThreadCreate(ThreadCb cb, void* userData /*= nullptr */)
+{
+	return ThreadCreate(nullptr, cb, 0, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the thread and detaches it
+//
+void ThreadCreateAndDetach(const char* name, ThreadCb cb, size_t stackSize /*= 0*/, void* userData /*= nullptr */)
+{
+	ThreadHandle handle = ThreadCreate(name, cb, stackSize, userData);
+	ThreadDetach(handle);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the thread and detaches it
+//
+void ThreadCreateAndDetach(const char* name, ThreadCb cb, void* userData /*= nullptr */)
+{
+	ThreadCreateAndDetach(name, cb, 0, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the thread and detaches it
+//
+void ThreadCreateAndDetach(ThreadCb cb, void* userData /*= nullptr */)
+{
+	ThreadCreateAndDetach(nullptr, cb, 0, userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the name the calling thread was given, the pointer is the one passed to ThreadSetName
+//
+const char* ThreadGetName()
+{
+	return t_threadName;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of logical cores, at least 1
+//
+int ThreadGetCoreCount()
+{
+	int coreCount = (int) std::thread::hardware_concurrency();
+	return coreCount > 0 ? coreCount : 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a mask with a bit set for every logical core (capped at 64 cores)
+//
+uint64_t ThreadGetAllCoresMask()
+{
+	int coreCount = ThreadGetCoreCount();
+	if(coreCount >= 64)
+	{
+		return ~(uint64_t) 0;
+	}
+
+	return ((uint64_t) 1 << coreCount) - 1;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Core/Types.hpp"
+#include "Engine/Enumerations/ThreadPriority.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -40,6 +41,14 @@ uintptr_t		ThreadGetID( ThreadHandle handle );
 void			ThreadSleep( int ms );
 void			ThreadYield();
 
+//-----------------------------------------------------------------------------------------------
+// Thread scheduling functions (nullptr handle is the calling thread)
+bool			ThreadSetAffinity( ThreadHandle handle, uint64_t coreMask ); // Bit n = core n
+bool			ThreadSetPriority( ThreadHandle handle, ThreadPriority priority );
+int				ThreadGetCoreCount();
+uint64_t		ThreadGetAllCoresMask();
+
 //-----------------------------------------------------------------------------------------------
 // Thread debug functions
 void			ThreadSetName( const char* name );
+const char*		ThreadGetName(); // Name last set on the calling thread, null if it has none
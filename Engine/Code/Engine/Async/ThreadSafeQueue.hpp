@@ -14,7 +14,9 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	ThreadSafeQueue(){}
+	explicit ThreadSafeQueue( const char* lockName ) : m_lock(lockName) {} // Named locks report contention to the profiler
 	~ThreadSafeQueue(){}
+	ALIGNED_NEW_AND_DELETE(ThreadSafeQueue) // Its lock is cache line aligned
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
@@ -14,7 +14,9 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	ThreadSafeVector(){}
+	explicit ThreadSafeVector( const char* lockName ) : m_lock(lockName) {} // Named locks report contention to the profiler
 	~ThreadSafeVector(){}
+	ALIGNED_NEW_AND_DELETE(ThreadSafeVector) // Its lock is cache line aligned
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
@@ -28,6 +28,7 @@ public:
 	// Constructors/Destructors
 	DevConsole(float width, float height);
 	~DevConsole();
+	ALIGNED_NEW_AND_DELETE(DevConsole) // Its text buffer's lock is cache line aligned
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
@@ -0,0 +1,49 @@
+#include "Engine/Core/AlignedAllocation.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/ErrorWarningAssert.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Allocates memory starting on a multiple of the alignment
+//
+void* AlignedAllocate(size_t size, size_t alignment)
+{
+	if(alignment < sizeof(void*))
+	{
+		alignment = sizeof(void*);
+	}
+
+#if defined(_WIN32)
+	void* memory = _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	if(posix_memalign(&memory, alignment, size) != 0)
+	{
+		memory = nullptr;
+	}
+#endif
+
+	GUARANTEE_OR_DIE(memory != nullptr, "Out of memory");
+	return memory;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Frees memory from AlignedAllocate
+//
+void AlignedFree(void* memory)
+{
+#if defined(_WIN32)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
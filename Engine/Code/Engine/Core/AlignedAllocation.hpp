@@ -0,0 +1,17 @@
+#pragma once
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void*	AlignedAllocate( size_t size, size_t alignment ); // Alignment must be a power of two, dies if out of memory
+void	AlignedFree( void* memory );
+
+//-----------------------------------------------------------------------------------------------
+// Global new ignores alignas above 16 bytes before C++17. Types that are, or hold, cache line
+// aligned members put this in their body so heap copies keep that alignment. Arrays of them are
+// allocated with AlignedAllocate and placement new instead, the array cookie would offset them
+#define ALIGNED_NEW_AND_DELETE(type) \
+	static void*	operator new( size_t size ) { return AlignedAllocate(size, alignof(type)); } \
+	static void*	operator new( size_t, void* place ) { return place; } \
+	static void		operator delete( void* memory ) { AlignedFree(memory); } \
+	static void		operator delete( void*, void* ) {}
@@ -8,6 +8,9 @@
 #include "Engine/Console/DevConsole.hpp"
 #include "Engine/Profiler/Profiler.hpp"
 #include "Engine/Logger/Logger.hpp"
+#include "Engine/Async/JobSystem.hpp"
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/EngineConfig.hpp"
 
 //-----------------------------------------------------------------------------------------------
 Blackboard	g_gameConfigBlackboard;
@@ -17,7 +20,12 @@ Blackboard	g_gameConfigBlackboard;
 //
 void EngineStartup()
 {
+	// The main thread owns its core, logger and job workers are kept off it
+	ThreadSetAffinity(nullptr, (uint64_t) 1 << ENGINE_MAIN_THREAD_CORE);
+	ThreadSetName("Main Thread");
+
 	LogSystemStartup();
+	JobSystemStartup();
 	ClockSystemStartup();
 	RenderingSystemStartup();
 	DebugRendererStartup();
@@ -38,6 +46,7 @@ void EngineShutdown()
 	DebugRendererShutdown();
 	RenderingSystemShutdown();
 	ProfilerShutdown();
+	JobSystemShutdown();
 	LogSystemShutdown();
 }
 
@@ -28,6 +28,7 @@ constexpr	char*	DEV_KURISU_ANIM = "Data/Definitions/kurisu.anim.xml";
 #define UNUSED(x) (void)(x);
 #define STATIC 
 #define PROFILER_START_FRAME_TEXT	"Frame Start"
+#define PROFILER_MAIN_THREAD_NAME	"Main Thread"
 
 // Source from http://www.flipcode.com/archives/FIXME_TODO_Notes_As_Warnings_In_Compiler_Output.shtml
 #define _QUOTE(x) # x
@@ -18,3 +18,46 @@
 //-----------------------------------------------------------------------------------------------
 // Profiler Config
 #define PROFILER_HISTORY_SIZE		128
+#define PROFILER_ARENA_BLOCK_SAMPLES	256 // Samples per allocation of a frame's arena, blocks are reused once warm
+#define PROFILER_THREAD_EVENTS		(8 * 1024) // Scope begins and ends a thread can record between frames, must be a power of two
+#define PROFILER_THREAD_COUNTER_READINGS	512 // Hardware counter reads of counted scopes a thread can record between frames, must be a power of two
+#define PROFILER_HISTOGRAM_BUCKETS	10 // Buckets of the frame time histograms in the history report
+#define PROFILER_USE_TSC // Time scopes with the CPU's cycle counter when it is invariant
+#define PROFILER_TSC_CALIBRATION_MS	20 // How long the cycle counter is timed against the performance counter at startup
+#define PROFILER_SAMPLER_DEFAULT_HZ	1000 // Stack samples per second of each thread's CPU time in sampling mode
+#define PROFILER_SAMPLER_MAX_FRAMES	48 // Deeper stacks lose their outermost frames
+#define PROFILER_SAMPLER_RING_SIZE	256 // Stack samples a thread can hold between frames, must be a power of two
+#define PROFILER_FRAME_BUDGET_MS	22.f // Frames slower than this are kept as hitches, 0 turns the alarm off
+#define PROFILER_HITCH_CONTEXT_FRAMES	4 // Frames kept before and after each slow frame, must be less than the history
+#define PROFILER_HITCH_MAX_FRAMES	(PROFILER_HITCH_CONTEXT_FRAMES + PROFILER_HISTORY_SIZE) // A hitch this long is written out, and the next slow frame starts another
+#define PROFILER_MAX_HITCHES		16 // Hitches kept in memory, later ones are only written to disk
+#define PROFILER_TRACK_ALLOCATIONS // Replaces global new/delete so scopes can report what they allocate, counting starts with profiler_allocs on
+
+//-----------------------------------------------------------------------------------------------
+// Thread Config
+#define ENGINE_MAIN_THREAD_CORE		0 // Main/render thread is pinned here, other threads avoid it
+
+//-----------------------------------------------------------------------------------------------
+// Job System Config
+#define JOB_MAX_JOBS_PER_WORKER		4096 // Must be a power of two
+#define JOB_MAX_DATA_SIZE			32
+
+//-----------------------------------------------------------------------------------------------
+// Logger Config
+#define LOG_FLUSH_INTERVAL_MS		100 // Longest the logger thread sleeps before writing out whatever is queued
+#define LOG_THREAD_BUFFER_SIZE		(64 * 1024) // Per logging thread, must be a power of two
+#define LOG_MAX_MESSAGE_LENGTH		2048
+#define LOG_MAX_TAG_LENGTH			64
+#define LOG_MAX_TAGS				256 // Distinct tags that can be filtered one by one, later ones follow logenableall/logdisableall
+#define LOG_ROTATE_MAX_BYTES		(16 * 1024 * 1024) // Active log file is closed and a new segment started past this size
+#define LOG_ROTATE_MAX_SECONDS		(60 * 60) // ...or once it has been open this long
+#define LOG_MAX_RETAINED_SEGMENTS	16 // Closed segments kept per log, the oldest are deleted first
+#define LOG_ARCHIVE_QUEUE_SIZE		64 // Compress and delete jobs waiting for the archiver, must be a power of two
+#define LOG_REOPEN_RETRY_SECONDS	5 // How often a log segment that couldn't be created is tried again
+#define LOG_COMPRESS_SEGMENTS // Gzip closed segments on a low priority thread
+#define LOG_COLLAPSE_REPEATS // Identical messages in a row from one thread are written once with a repeat count
+#define LOG_REPEAT_WINDOW_MS		1000 // ...as long as they come within this long of the first one
+#define LOG_SUPPRESSED_REPORT_MS	1000 // How often rate limited tags report how many messages they dropped
+#define LOG_ENABLE_FLIGHT_RECORDER // Recent messages and profiler frames are also copied into a memory mapped ring that survives crashes
+#define LOG_FLIGHT_RECORDER_SIZE		(1024 * 1024)
+#define LOG_FLIGHT_RECORDER_SLOT_SIZE	256 // One entry per slot, must be a power of two. Longer messages are truncated in the ring
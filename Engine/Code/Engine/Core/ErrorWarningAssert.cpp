@@ -15,6 +15,7 @@
 #include <stdarg.h>
 #include <iostream>
 #include "Engine/Logger/Logger.hpp"
+#include "Engine/Logger/LogFlightRecorder.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -45,6 +46,11 @@ bool IsDebuggerAvailable()
 //-----------------------------------------------------------------------------------------------
 void DebuggerPrintf( const char* messageFormat, ... )
 {
+	if( !LogIsTagEnabled( "debug" ) )
+	{
+		return; // Hidden by default, don't pay for the formatting
+	}
+
 	const int MESSAGE_MAX_LENGTH = 2048;
 	char messageLiteral[ MESSAGE_MAX_LENGTH ];
 	va_list variableArgumentList;
@@ -53,7 +59,7 @@ void DebuggerPrintf( const char* messageFormat, ... )
 	va_end( variableArgumentList );
 	messageLiteral[ MESSAGE_MAX_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-	LogTaggedPrintf("debug", messageLiteral);
+	LogTaggedPrintf("debug", "%s", messageLiteral);
 	
 }
 
@@ -229,6 +235,9 @@ __declspec( noreturn ) void FatalError( const char* filePath, const char* functi
 			lineNum, fileName, functionName );
 	}
 
+	// On disk before any dialogue, in case the process never gets past it
+	FlightRecorderMarkError( Stringf( "%s(%d): %s", filePath, lineNum, errorMessage.c_str() ).c_str(), true );
+
 	DebuggerPrintf( "\n==============================================================================\n" );
 	DebuggerPrintf( "RUN-TIME FATAL ERROR on line %i of %s, in %s()\n", lineNum, fileName, functionName );
 	DebuggerPrintf( "%s(%d): %s\n", filePath, lineNum, errorMessage.c_str() ); // Use this specific format so Visual Studio users can double-click to jump to file-and-line of error
@@ -1,5 +1,6 @@
 #include "Engine/Core/StringUtils.hpp"
 #include <stdarg.h>
+#include <stdio.h>
 
 
 //-----------------------------------------------------------------------------------------------
@@ -42,6 +43,33 @@ const std::string Stringf( const int maxLength, const char* format, ... )
 }
 
 
-
-
+//-----------------------------------------------------------------------------------------------
+void AppendJsonString( std::string& outJson, const char* text )
+{
+	outJson += '"';
+	for( const char* character = text; *character != '\0'; ++character )
+	{
+		switch( *character )
+		{
+		case '"':	outJson += "\\\"";	break;
+		case '\\':	outJson += "\\\\";	break;
+		case '\n':	outJson += "\\n";		break;
+		case '\r':	outJson += "\\r";		break;
+		case '\t':	outJson += "\\t";		break;
+		default:
+			if( (unsigned char) *character < 0x20 )
+			{
+				char escaped[8];
+				snprintf( escaped, sizeof( escaped ), "\\u%04x", (unsigned int) (unsigned char) *character );
+				outJson += escaped;
+			}
+			else
+			{
+				outJson += *character;
+			}
+			break;
+		}
+	}
+	outJson += '"';
+}
 
@@ -8,6 +8,7 @@ typedef std::vector<std::string> Strings;
 //-----------------------------------------------------------------------------------------------
 const std::string Stringf( const char* format, ... );
 const std::string Stringf( const int maxLength, const char* format, ... );
+void AppendJsonString( std::string& outJson, const char* text ); // Quoted, with quotes, backslashes and control characters escaped
 
 
 
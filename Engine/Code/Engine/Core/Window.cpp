@@ -54,7 +54,7 @@ static void RegisterWindowClass()
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
-Window::Window(const char* title, float clientAspect)
+Window::Window(const char* title, float clientAspect, bool isVisible)
 {
 	RegisterWindowClass(); 
 
@@ -117,9 +117,12 @@ Window::Window(const char* title, float clientAspect)
 		GetModuleHandle( NULL ),
 		NULL );
 
-	ShowWindow( hwnd, SW_SHOW );
-	SetForegroundWindow( hwnd );
-	SetFocus( hwnd );
+	if(isVisible)
+	{
+		ShowWindow( hwnd, SW_SHOW );
+		SetForegroundWindow( hwnd );
+		SetFocus( hwnd );
+	}
 
 	m_hWnd = (void*)hwnd; 
 }
@@ -173,10 +176,10 @@ void Window::RemoveAllHandlers()
 //-----------------------------------------------------------------------------------------------
 // Creates a window
 //
-STATIC Window* Window::CreateInstance(const char* title, float aspect)
+STATIC Window* Window::CreateInstance(const char* title, float aspect, bool isVisible /*= true */)
 {
 	if (g_Window == nullptr) {
-		g_Window = new Window( title, aspect ); 
+		g_Window = new Window( title, aspect, isVisible ); 
 	}
 	return g_Window; 
 }
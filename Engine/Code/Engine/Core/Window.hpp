@@ -11,7 +11,7 @@ class Window
 private:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
-	Window( const char* title, float clientAspect );
+	Window( const char* title, float clientAspect, bool isVisible );
 public:
 	~Window();
 	
@@ -26,7 +26,7 @@ public:
 			void	AddHandler( windowsMessageHandlerCB cb );
 			void	RemoveHandler( windowsMessageHandlerCB cb );
 			void	RemoveAllHandlers(); 
-	static  Window*	CreateInstance( const char* title, float aspect );
+	static  Window*	CreateInstance( const char* title, float aspect, bool isVisible = true ); // Hidden windows still get a GL context, for headless runs
 	static	Window* GetInstance();
 	static	void	DestroyInstance();
 
@@ -20,6 +20,7 @@ char* GetFileModeString(FileMode mode)
 	case FILE_READ:		return "r"; break;
 	case FILE_WRITE:	return "w"; break;
 	case FILE_APPEND:	return "a"; break;
+	case FILE_WRITE_BINARY:	return "wb"; break;
 	default:
 		GUARANTEE_OR_DIE(false, "Bad file mode selection");
 		break;
@@ -11,6 +11,7 @@ enum FileMode
 	FILE_READ,
 	FILE_WRITE,
 	FILE_APPEND,
+	FILE_WRITE_BINARY,
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -0,0 +1,13 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+enum LogMode
+{
+	LOG_MODE_TEXT,		// Formatted on the calling thread, written as text
+	LOG_MODE_BINARY,	// Format pointer and raw args written to a .binlog, formatted offline
+	NUM_LOG_MODES
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+//-----------------------------------------------------------------------------------------------
+enum ProfilerCounterType
+{
+	PROFILER_COUNTER_CYCLES,
+	PROFILER_COUNTER_INSTRUCTIONS,
+	PROFILER_COUNTER_CACHE_REFERENCES,
+	PROFILER_COUNTER_CACHE_MISSES,
+	PROFILER_COUNTER_BRANCHES,
+	PROFILER_COUNTER_BRANCH_MISSES,
+	NUM_PROFILER_COUNTERS
+};
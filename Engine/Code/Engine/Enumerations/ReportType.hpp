@@ -10,6 +10,9 @@ enum ReportType
 {
 	REPORT_TYPE_FLAT,
 	REPORT_TYPE_TREE,
+	REPORT_TYPE_HISTORY, // Every scope aggregated over the whole history
+	REPORT_TYPE_SAMPLED_TREE, // Call stacks from sampling mode
+	REPORT_TYPE_SAMPLED_FLAT,
 	NUM_REPORT_TYPES
 };
 
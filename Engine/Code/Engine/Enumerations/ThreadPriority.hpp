@@ -0,0 +1,17 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Prefixed PRIO to stay clear of the Win32 THREAD_PRIORITY_* defines
+enum ThreadPriority
+{
+	THREAD_PRIO_LOWEST,
+	THREAD_PRIO_LOW,
+	THREAD_PRIO_NORMAL,
+	THREAD_PRIO_HIGH,
+	THREAD_PRIO_HIGHEST,
+	NUM_THREAD_PRIORITIES
+};
@@ -5,6 +5,15 @@
 #define STBI_MSC_SECURE_CRT
 #include "ThirdParty/stb/stb_image_write.h"
 
+#if !defined(_WIN32)
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define FILE_MAX_GATHER_SPANS	256 // Spans handed to a single writev call
+
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
@@ -40,6 +49,7 @@ int File::Open(const char* fileName, FileMode mode)
 void File::Close()
 {
 	fclose(fp);
+	fp = nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -76,6 +86,55 @@ void File::Printf(const char* format, ...)
 	va_end(args);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Writes all the spans in order, with one system call per FILE_MAX_GATHER_SPANS spans on POSIX
+//
+void File::WriteGather(const FileWriteSpan* spans, size_t count)
+{
+#if defined(_WIN32)
+	// Windows can only gather into unbuffered handles, let stdio coalesce the spans instead
+	for(size_t index = 0; index < count; ++index)
+	{
+		fwrite(spans[index].data, sizeof(char), spans[index].size, fp);
+	}
+#else
+	fflush(fp); // Anything written through stdio goes first
+	int fileDesc = fileno(fp);
+
+	struct iovec vecs[FILE_MAX_GATHER_SPANS];
+	size_t spanIndex = 0;
+	size_t spanOffset = 0; // Bytes of spans[spanIndex] already written
+
+	while(spanIndex < count)
+	{
+		int vecCount = 0;
+		for(size_t index = spanIndex; index < count && vecCount < FILE_MAX_GATHER_SPANS; ++index)
+		{
+			size_t offset = index == spanIndex ? spanOffset : 0;
+			vecs[vecCount].iov_base = (char*) spans[index].data + offset;
+			vecs[vecCount].iov_len = spans[index].size - offset;
+			vecCount++;
+		}
+
+		ssize_t written = writev(fileDesc, vecs, vecCount);
+		if(written < 0)
+		{
+			return;
+		}
+
+		// Step over what was written, a short write resumes mid span
+		size_t remaining = (size_t) written;
+		while(spanIndex < count && remaining >= spans[spanIndex].size - spanOffset)
+		{
+			remaining -= spans[spanIndex].size - spanOffset;
+			spanIndex++;
+			spanOffset = 0;
+		}
+		spanOffset += remaining;
+	}
+#endif
+}
+
 //-----------------------------------------------------------------------------------------------
 // Reads the file into a buffer
 //
@@ -130,6 +189,62 @@ bool FileWriteToNewFile(const char* fileName, const char* bufferData, size_t cou
 	return true;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Compresses a file into gzip format with the deflate encoder stb uses for PNGs
+//
+bool FileCompressToGzip(const char* fileName, const char* gzipFileName)
+{
+	FILE* fp = nullptr;
+	fopen_s(&fp, fileName, "rb");
+
+	if(fp == nullptr)
+	{
+		return false;
+	}
+
+	fseek(fp, 0L, SEEK_END);
+	size_t size = (size_t) ftell(fp);
+	fseek(fp, 0L, SEEK_SET);
+
+	unsigned char* data = (unsigned char*) malloc(size + 1U);
+	size = fread(data, 1, size, fp);
+	fclose(fp);
+
+	int zlibSize = 0;
+	unsigned char* zlib = stbi_zlib_compress(data, (int) size, &zlibSize, 8);
+	unsigned int crc = stbiw__crc32(data, (int) size);
+	free(data);
+
+	if(zlib == nullptr || zlibSize < 6)
+	{
+		free(zlib);
+		return false;
+	}
+
+	fopen_s(&fp, gzipFileName, "wb");
+	if(fp == nullptr)
+	{
+		free(zlib);
+		return false;
+	}
+
+	// gzip wraps the raw deflate stream, so drop zlib's 2 byte header and adler32 trailer
+	const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+	const unsigned char trailer[8] = {
+		(unsigned char) crc, (unsigned char) (crc >> 8), (unsigned char) (crc >> 16), (unsigned char) (crc >> 24),
+		(unsigned char) size, (unsigned char) (size >> 8), (unsigned char) (size >> 16), (unsigned char) (size >> 24) };
+
+	fwrite(header, 1, sizeof(header), fp);
+	fwrite(zlib + 2, 1, zlibSize - 6, fp);
+	fwrite(trailer, 1, sizeof(trailer), fp);
+
+	bool isWritten = ferror(fp) == 0;
+	fclose(fp);
+	free(zlib);
+
+	return isWritten;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Appends data to the end of the file
 //
@@ -5,6 +5,14 @@
 // Forward Declarations
 
 
+//-----------------------------------------------------------------------------------------------
+// One span of a gathered write
+struct FileWriteSpan
+{
+	const void*	data;
+	size_t		size;
+};
+
 //-----------------------------------------------------------------------------------------------
 class File
 {
@@ -24,6 +32,7 @@ public:
 	void	Flush();
 	void	Printv( const char* format, va_list args );
 	void	Printf( const char* format, ... );
+	void	WriteGather( const FileWriteSpan* spans, size_t count ); // Vectored write where the platform has one
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
@@ -43,5 +52,8 @@ bool FileWriteToNewFile( const char* filename, const char* data, size_t length )
 // Appends a buffer into a file
 bool FileAppendToFile( const char* fileName, const char* data, size_t length );
 
+// Compresses a file into a .gz file
+bool FileCompressToGzip( const char* fileName, const char* gzipFileName );
+
 // Write to a png file
 bool WriteToPng( const char* filename, const unsigned char* data, int width, int height, int numComponents );
\ No newline at end of file
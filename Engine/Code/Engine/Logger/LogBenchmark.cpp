@@ -0,0 +1,247 @@
+#include "Engine/Logger/LogBenchmark.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Logger/Logger.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define LOG_BENCHMARK_MAX_PROBES		1000
+#define LOG_BENCHMARK_PROBE_TAG			"benchprobe"
+
+//-----------------------------------------------------------------------------------------------
+// Types
+struct LogBenchmarkWorker
+{
+	const LogBenchmarkConfig*			config = nullptr;
+	const std::vector<std::string>*		tags = nullptr;
+	std::string							text;
+	std::vector<uint64_t>				latencies; // Performance counter ticks per log call
+	std::atomic<int>*					readyCount = nullptr;
+	std::atomic<int>*					doneCount = nullptr;
+	std::atomic<bool>*					isStarted = nullptr;
+	uint64_t							endHpc = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Logs the worker's share of messages and times every call
+//
+static void LogBenchmarkWorkerMain(void* userData)
+{
+	LogBenchmarkWorker* worker = (LogBenchmarkWorker*) userData;
+	const std::vector<std::string>& tags = *worker->tags;
+	int messageCount = worker->config->messagesPerThread;
+
+	// Create the thread's log buffer outside the measured part
+	Logger::GetInstance()->GetThreadBuffer();
+
+	worker->readyCount->fetch_add(1);
+	while(!worker->isStarted->load(std::memory_order_acquire))
+	{
+		ThreadYield();
+	}
+
+	for(int messageIndex = 0; messageIndex < messageCount; ++messageIndex)
+	{
+		const char* tag = tags[messageIndex % tags.size()].c_str();
+
+		uint64_t startHpc = Time::GetPerformanceCounter();
+		LogTaggedPrintf(tag, "%d %s\n", messageIndex, worker->text.c_str());
+		worker->latencies[messageIndex] = Time::GetPerformanceCounter() - startHpc;
+	}
+
+	worker->endHpc = Time::GetPerformanceCounter();
+	worker->doneCount->fetch_add(1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the value at the given fraction of the sorted samples
+//
+static uint64_t GetPercentile(std::vector<uint64_t>& samples, double fraction)
+{
+	if(samples.empty())
+	{
+		return 0;
+	}
+
+	size_t index = (size_t) (fraction * (double) (samples.size() - 1) + 0.5);
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Drives the running logger from worker threads and measures it
+//
+LogBenchmarkResult LogRunBenchmark(const LogBenchmarkConfig& config)
+{
+	LogBenchmarkResult result;
+	result.config = config;
+
+	int threadCount = std::max(config.threadCount, 1);
+	int tagCount = std::max(config.tagCount, 1);
+	int hiddenTagCount = std::min(tagCount * std::max(config.hiddenTagPercent, 0) / 100, tagCount);
+
+	std::vector<std::string> tags;
+	for(int tagIndex = 0; tagIndex < tagCount; ++tagIndex)
+	{
+		tags.push_back("bench" + std::to_string(tagIndex));
+		if(tagIndex < hiddenTagCount)
+		{
+			LogHideTag(tags.back().c_str());
+		}
+		else
+		{
+			LogShowTag(tags.back().c_str());
+		}
+	}
+	LogShowTag(LOG_BENCHMARK_PROBE_TAG);
+
+	LogMode previousMode = Logger::GetInstance()->GetMode();
+	LogSetMode(config.mode);
+
+	// Start from an empty logger so earlier messages don't count
+	LogFlush();
+
+	std::atomic<int> readyCount{0};
+	std::atomic<int> doneCount{0};
+	std::atomic<bool> isStarted{false};
+
+	std::vector<LogBenchmarkWorker> workers(threadCount);
+	std::vector<ThreadHandle> threads;
+	for(LogBenchmarkWorker& worker : workers)
+	{
+		worker.config = &config;
+		worker.tags = &tags;
+		worker.text.assign(std::max(config.messageSize, 0), 'x');
+		worker.latencies.resize(std::max(config.messagesPerThread, 0));
+		worker.readyCount = &readyCount;
+		worker.doneCount = &doneCount;
+		worker.isStarted = &isStarted;
+
+		threads.push_back(ThreadCreate("Log Benchmark", LogBenchmarkWorkerMain, &worker));
+	}
+
+	while(readyCount.load() < threadCount)
+	{
+		ThreadYield();
+	}
+
+	uint64_t startHpc = Time::GetPerformanceCounter();
+	isStarted.store(true, std::memory_order_release);
+
+	// Time to disk under load: log one message and wait until the logger has written it out
+	std::vector<uint64_t> probes;
+	while(doneCount.load() < threadCount && probes.size() < LOG_BENCHMARK_MAX_PROBES)
+	{
+		uint64_t probeHpc = Time::GetPerformanceCounter();
+		LogTaggedPrintf(LOG_BENCHMARK_PROBE_TAG, "probe\n");
+		LogFlush();
+		probes.push_back(Time::GetPerformanceCounter() - probeHpc);
+
+		ThreadSleep(1);
+	}
+
+	for(ThreadHandle thread : threads)
+	{
+		ThreadJoin(thread);
+	}
+
+	uint64_t endHpc = startHpc;
+	for(const LogBenchmarkWorker& worker : workers)
+	{
+		endHpc = std::max(endHpc, worker.endHpc);
+	}
+
+	LogFlush();
+	uint64_t drainedHpc = Time::GetPerformanceCounter();
+
+	// Gather the numbers
+	std::vector<uint64_t> latencies;
+	for(const LogBenchmarkWorker& worker : workers)
+	{
+		latencies.insert(latencies.end(), worker.latencies.begin(), worker.latencies.end());
+	}
+
+	result.messageCount = latencies.size();
+	result.logSeconds = Time::HpcToSeconds(endHpc - startHpc);
+	result.messagesPerSecond = result.logSeconds > 0.0 ? (double) result.messageCount / result.logSeconds : 0.0;
+	result.enqueueP50Us = Time::HpcToSeconds(GetPercentile(latencies, 0.5)) * 1000000.0;
+	result.enqueueP99Us = Time::HpcToSeconds(GetPercentile(latencies, 0.99)) * 1000000.0;
+	result.enqueueP999Us = Time::HpcToSeconds(GetPercentile(latencies, 0.999)) * 1000000.0;
+	result.enqueueMaxUs = Time::HpcToSeconds(GetPercentile(latencies, 1.0)) * 1000000.0;
+	result.diskP50Ms = Time::HpcToSeconds(GetPercentile(probes, 0.5)) * 1000.0;
+	result.diskP99Ms = Time::HpcToSeconds(GetPercentile(probes, 0.99)) * 1000.0;
+	result.diskMaxMs = Time::HpcToSeconds(GetPercentile(probes, 1.0)) * 1000.0;
+	result.drainMs = Time::HpcToSeconds(drainedHpc - endHpc) * 1000.0;
+
+	// Put the logger back how we found it
+	LogSetMode(previousMode);
+	for(int tagIndex = 0; tagIndex < hiddenTagCount; ++tagIndex)
+	{
+		LogShowTag(tags[tagIndex].c_str());
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs threads x message sizes x hidden ratios x modes
+//
+void LogRunBenchmarkSuite(std::vector<LogBenchmarkResult>& outResults)
+{
+	const int threadCounts[] = { 1, 4, 8 };
+	const int messageSizes[] = { 32, 512 };
+	const int hiddenTagPercents[] = { 0, 50 };
+
+	for(int threadCount : threadCounts)
+	{
+		for(int messageSize : messageSizes)
+		{
+			for(int hiddenTagPercent : hiddenTagPercents)
+			{
+				for(int mode = 0; mode < NUM_LOG_MODES; ++mode)
+				{
+					LogBenchmarkConfig config;
+					config.threadCount = threadCount;
+					config.messagesPerThread = 20000;
+					config.messageSize = messageSize;
+					config.hiddenTagPercent = hiddenTagPercent;
+					config.mode = (LogMode) mode;
+
+					outResults.push_back(LogRunBenchmark(config));
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One JSON object per result, on one line
+//
+std::string LogBenchmarkToJson(const LogBenchmarkResult& result)
+{
+	const LogBenchmarkConfig& config = result.config;
+
+	char json[1024];
+	snprintf(json, sizeof(json),
+		"{\"threads\":%d,\"messagesPerThread\":%d,\"messageSize\":%d,\"tags\":%d,\"hiddenTagPercent\":%d,\"mode\":\"%s\","
+		"\"messages\":%llu,\"seconds\":%.6f,\"messagesPerSecond\":%.1f,"
+		"\"enqueueUs\":{\"p50\":%.3f,\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f},"
+		"\"timeToDiskMs\":{\"p50\":%.3f,\"p99\":%.3f,\"max\":%.3f},\"drainMs\":%.3f}",
+		config.threadCount, config.messagesPerThread, config.messageSize, config.tagCount, config.hiddenTagPercent,
+		config.mode == LOG_MODE_BINARY ? "binary" : "text",
+		(unsigned long long) result.messageCount, result.logSeconds, result.messagesPerSecond,
+		result.enqueueP50Us, result.enqueueP99Us, result.enqueueP999Us, result.enqueueMaxUs,
+		result.diskP50Ms, result.diskP99Ms, result.diskMaxMs, result.drainMs);
+
+	return json;
+}
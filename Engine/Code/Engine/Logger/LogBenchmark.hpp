@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Engine/Enumerations/LogMode.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// One benchmark run. Messages cycle through tagCount tags, hiddenTagPercent of which are hidden
+struct LogBenchmarkConfig
+{
+	int		threadCount			= 4;
+	int		messagesPerThread	= 50000;
+	int		messageSize			= 64; // Characters of text per message
+	int		tagCount			= 4;
+	int		hiddenTagPercent	= 0;
+	LogMode	mode				= LOG_MODE_TEXT;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct LogBenchmarkResult
+{
+	LogBenchmarkConfig	config;
+	uint64_t			messageCount = 0; // Logged, hidden ones included
+	double				logSeconds = 0.0; // Start until the last worker finished logging
+	double				messagesPerSecond = 0.0;
+	double				enqueueP50Us = 0.0; // Time spent inside each log call
+	double				enqueueP99Us = 0.0;
+	double				enqueueP999Us = 0.0;
+	double				enqueueMaxUs = 0.0;
+	double				diskP50Ms = 0.0; // Probe message logged and flushed to disk while the workers run
+	double				diskP99Ms = 0.0;
+	double				diskMaxMs = 0.0;
+	double				drainMs = 0.0; // Last worker done until everything was on disk
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+
+// Drives the running logger from worker threads, the messages go to the real log. Blocks until done
+LogBenchmarkResult	LogRunBenchmark( const LogBenchmarkConfig& config );
+
+// Runs threads x message sizes x hidden ratios x modes
+void				LogRunBenchmarkSuite( std::vector<LogBenchmarkResult>& outResults );
+
+// One JSON object per result, on one line
+std::string			LogBenchmarkToJson( const LogBenchmarkResult& result );
@@ -0,0 +1,618 @@
+#include "Engine/Logger/LogBinaryFormat.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineConfig.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define LOG_MAX_SPEC_LENGTH		32 // Longer conversions are copied to the text as they are
+
+//-----------------------------------------------------------------------------------------------
+// Types
+
+// How an argument is stored in the stream
+enum LogArgType
+{
+	LOG_ARG_NONE,			// "%%" or something we don't understand, nothing is consumed
+	LOG_ARG_INT32,
+	LOG_ARG_INT64,
+	LOG_ARG_DOUBLE,
+	LOG_ARG_STRING,
+	LOG_ARG_WIDE_STRING,	// Stored as a narrow string
+	LOG_ARG_POINTER,
+	LOG_ARG_COUNT_POINTER	// "%n", consumed but never stored
+};
+
+// How an argument is read from the va_list
+enum LogArgSource
+{
+	LOG_SOURCE_INT,
+	LOG_SOURCE_LONG,
+	LOG_SOURCE_LONG_LONG,
+	LOG_SOURCE_SIZE,
+	LOG_SOURCE_PTRDIFF,
+	LOG_SOURCE_DOUBLE,
+	LOG_SOURCE_LONG_DOUBLE
+};
+
+// One conversion in a format string
+struct LogFormatSpec
+{
+	const char*		start;			// The '%'
+	size_t			length;			// Up to and including the conversion character
+	size_t			modifierStart;	// Length modifier, relative to start
+	size_t			modifierLength;
+	int				starCount;		// '*' widths/precisions that come before the value
+	int				precision;		// Literal precision, -1 if there is none or it is a '*'
+	bool			hasStarPrecision; // The last '*' argument is the precision
+	LogArgType		type;
+	LogArgSource	source;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Finds the next conversion in the format string. Returns false once there are none left
+//
+static bool FindNextSpec(const char* format, LogFormatSpec* outSpec)
+{
+	const char* percent = strchr(format, '%');
+	if(percent == nullptr)
+	{
+		return false;
+	}
+
+	outSpec->start = percent;
+	outSpec->starCount = 0;
+	outSpec->precision = -1;
+	outSpec->hasStarPrecision = false;
+	outSpec->type = LOG_ARG_NONE;
+	outSpec->source = LOG_SOURCE_INT;
+	outSpec->modifierStart = 0;
+	outSpec->modifierLength = 0;
+
+	const char* cursor = percent + 1;
+	if(*cursor == '%')
+	{
+		outSpec->length = 2;
+		return true;
+	}
+
+	// Flags, width and precision
+	while(*cursor != '\0' && strchr("-+ #0'", *cursor) != nullptr)
+	{
+		cursor++;
+	}
+
+	if(*cursor == '*')
+	{
+		outSpec->starCount++;
+		cursor++;
+	}
+	while(*cursor >= '0' && *cursor <= '9')
+	{
+		cursor++;
+	}
+
+	if(*cursor == '.')
+	{
+		cursor++;
+		if(*cursor == '*')
+		{
+			outSpec->starCount++;
+			outSpec->hasStarPrecision = true;
+			cursor++;
+		}
+		else
+		{
+			outSpec->precision = 0; // A lone '.' means zero
+			while(*cursor >= '0' && *cursor <= '9')
+			{
+				outSpec->precision = outSpec->precision * 10 + (*cursor - '0');
+				cursor++;
+			}
+		}
+	}
+
+	// Length modifier
+	const char* modifier = cursor;
+	int longCount = 0;
+	bool isLongDouble = false;
+	LogArgSource sizedSource = LOG_SOURCE_INT;
+
+	while(*cursor != '\0' && strchr("hlLzjtqI", *cursor) != nullptr)
+	{
+		switch(*cursor)
+		{
+		case 'l':	longCount++;									break;
+		case 'L':	isLongDouble = true;							break;
+		case 'j':
+		case 'q':	sizedSource = LOG_SOURCE_LONG_LONG;				break;
+		case 'z':	sizedSource = LOG_SOURCE_SIZE;					break;
+		case 't':	sizedSource = LOG_SOURCE_PTRDIFF;				break;
+		case 'I': // MSVC sizes
+			if(cursor[1] == '6' && cursor[2] == '4')		{ sizedSource = LOG_SOURCE_LONG_LONG; cursor += 2; }
+			else if(cursor[1] == '3' && cursor[2] == '2')	{ sizedSource = LOG_SOURCE_INT; cursor += 2; }
+			else											{ sizedSource = LOG_SOURCE_SIZE; }
+			break;
+		default:													break;
+		}
+		cursor++;
+	}
+
+	outSpec->modifierStart = modifier - percent;
+	outSpec->modifierLength = cursor - modifier;
+
+	if(longCount == 1)
+	{
+		sizedSource = LOG_SOURCE_LONG;
+	}
+	else if(longCount > 1)
+	{
+		sizedSource = LOG_SOURCE_LONG_LONG;
+	}
+
+	switch(*cursor)
+	{
+	case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+		outSpec->source = sizedSource;
+		outSpec->type = sizedSource == LOG_SOURCE_INT ? LOG_ARG_INT32 : LOG_ARG_INT64;
+		break;
+	case 'c': case 'C':
+		outSpec->type = LOG_ARG_INT32;
+		break;
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		outSpec->type = LOG_ARG_DOUBLE;
+		outSpec->source = isLongDouble ? LOG_SOURCE_LONG_DOUBLE : LOG_SOURCE_DOUBLE;
+		break;
+	case 's':
+		outSpec->type = longCount > 0 ? LOG_ARG_WIDE_STRING : LOG_ARG_STRING;
+		break;
+	case 'S':
+		outSpec->type = LOG_ARG_WIDE_STRING;
+		break;
+	case 'p':
+		outSpec->type = LOG_ARG_POINTER;
+		break;
+	case 'n':
+		outSpec->type = LOG_ARG_COUNT_POINTER;
+		break;
+	case '\0':
+		outSpec->length = cursor - percent; // Dangling '%', printed as is
+		return true;
+	default:
+		break;
+	}
+
+	outSpec->length = cursor + 1 - percent;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends bytes to the encoded arguments. Returns false if they don't fit
+//
+static bool WriteArgBytes(char* outArgs, size_t capacity, size_t* size, const void* data, size_t dataSize)
+{
+	if(*size + dataSize > capacity)
+	{
+		return false;
+	}
+
+	memcpy(outArgs + *size, data, dataSize);
+	*size += dataSize;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads bytes from the encoded arguments. Returns false if there aren't enough left
+//
+static bool ReadArgBytes(const char* args, size_t argsSize, size_t* offset, void* outData, size_t dataSize)
+{
+	if(*offset + dataSize > argsSize)
+	{
+		return false;
+	}
+
+	memcpy(outData, args + *offset, dataSize);
+	*offset += dataSize;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends text, truncating at the capacity (which keeps room for a terminator)
+//
+static void AppendText(char* outText, size_t capacity, size_t* length, const char* text, size_t textLength)
+{
+	if(*length + 1 >= capacity)
+	{
+		return;
+	}
+
+	size_t room = capacity - *length - 1;
+	textLength = textLength < room ? textLength : room;
+
+	memcpy(outText + *length, text, textLength);
+	*length += textLength;
+	outText[*length] = '\0';
+}
+
+//-----------------------------------------------------------------------------------------------
+// Formats one value with however many '*' arguments its spec has
+//
+template<typename T>
+static int FormatValue(char* outText, size_t capacity, const char* specFormat, const int* stars, int starCount, T value)
+{
+	switch(starCount)
+	{
+	case 0:		return snprintf(outText, capacity, specFormat, value);
+	case 1:		return snprintf(outText, capacity, specFormat, stars[0], value);
+	default:	return snprintf(outText, capacity, specFormat, stars[0], stars[1], value);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Encodes the arguments the format string consumes into outArgs
+//
+size_t LogBinaryEncodeArgs(char* outArgs, size_t capacity, const char* format, va_list args)
+{
+	size_t size = 0;
+	LogFormatSpec spec;
+
+	while(FindNextSpec(format, &spec))
+	{
+		format = spec.start + spec.length;
+
+		int precision = spec.precision;
+		for(int star = 0; star < spec.starCount; ++star)
+		{
+			int starValue = va_arg(args, int);
+			if(!WriteArgBytes(outArgs, capacity, &size, &starValue, sizeof(starValue)))
+			{
+				return size;
+			}
+			precision = spec.hasStarPrecision ? starValue : precision; // The precision is always the last one
+		}
+
+		bool wasWritten = true;
+		switch(spec.type)
+		{
+		case LOG_ARG_INT32:
+		{
+			int32_t value = (int32_t) va_arg(args, int);
+			wasWritten = WriteArgBytes(outArgs, capacity, &size, &value, sizeof(value));
+			break;
+		}
+		case LOG_ARG_INT64:
+		{
+			int64_t value = 0;
+			switch(spec.source)
+			{
+			case LOG_SOURCE_LONG:		value = (int64_t) va_arg(args, long);		break;
+			case LOG_SOURCE_SIZE:		value = (int64_t) va_arg(args, size_t);		break;
+			case LOG_SOURCE_PTRDIFF:	value = (int64_t) va_arg(args, ptrdiff_t);	break;
+			default:					value = (int64_t) va_arg(args, long long);	break;
+			}
+			wasWritten = WriteArgBytes(outArgs, capacity, &size, &value, sizeof(value));
+			break;
+		}
+		case LOG_ARG_DOUBLE:
+		{
+			double value = spec.source == LOG_SOURCE_LONG_DOUBLE ? (double) va_arg(args, long double) : va_arg(args, double);
+			wasWritten = WriteArgBytes(outArgs, capacity, &size, &value, sizeof(value));
+			break;
+		}
+		case LOG_ARG_POINTER:
+		{
+			uint64_t value = (uint64_t) (uintptr_t) va_arg(args, void*);
+			wasWritten = WriteArgBytes(outArgs, capacity, &size, &value, sizeof(value));
+			break;
+		}
+		case LOG_ARG_STRING:
+		case LOG_ARG_WIDE_STRING:
+		{
+			// Length prefixed, truncated to whatever room is left
+			if(size + sizeof(uint32_t) > capacity)
+			{
+				return size;
+			}
+
+			uint32_t* lengthField = (uint32_t*) (outArgs + size);
+			char* chars = outArgs + size + sizeof(uint32_t);
+			size_t room = capacity - size - sizeof(uint32_t);
+			size_t length = 0;
+
+			// A precision is all printf reads, the string doesn't have to be terminated. Negative means none
+			if(precision >= 0 && (size_t) precision < room)
+			{
+				room = (size_t) precision;
+			}
+
+			if(spec.type == LOG_ARG_STRING)
+			{
+				const char* value = va_arg(args, const char*);
+				value = value != nullptr ? value : "(null)";
+
+				while(length < room && value[length] != '\0')
+				{
+					chars[length] = value[length];
+					length++;
+				}
+			}
+			else
+			{
+				// Only ASCII survives the trip
+				const wchar_t* value = va_arg(args, const wchar_t*);
+				value = value != nullptr ? value : L"(null)";
+
+				while(length < room && value[length] != L'\0')
+				{
+					chars[length] = value[length] < 128 ? (char) value[length] : '?';
+					length++;
+				}
+			}
+
+			uint32_t storedLength = (uint32_t) length;
+			memcpy(lengthField, &storedLength, sizeof(storedLength));
+			size += sizeof(uint32_t) + length;
+			break;
+		}
+		case LOG_ARG_COUNT_POINTER:
+			va_arg(args, void*);
+			break;
+		default:
+			break;
+		}
+
+		if(!wasWritten)
+		{
+			return size;
+		}
+	}
+
+	return size;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the message text from the format string and the encoded arguments
+//
+size_t LogBinaryFormatMessage(char* outText, size_t capacity, const char* format, const char* args, size_t argsSize)
+{
+	size_t length = 0;
+	size_t argOffset = 0;
+	LogFormatSpec spec;
+
+	if(capacity > 0)
+	{
+		outText[0] = '\0';
+	}
+
+	while(FindNextSpec(format, &spec))
+	{
+		AppendText(outText, capacity, &length, format, spec.start - format);
+		format = spec.start + spec.length;
+
+		if(spec.type == LOG_ARG_NONE || spec.length > LOG_MAX_SPEC_LENGTH)
+		{
+			bool isPercent = spec.length == 2 && spec.start[1] == '%';
+			AppendText(outText, capacity, &length, isPercent ? "%" : spec.start, isPercent ? 1 : spec.length);
+			continue;
+		}
+
+		if(spec.type == LOG_ARG_COUNT_POINTER)
+		{
+			continue;
+		}
+
+		int stars[2] = { 0, 0 };
+		bool hasArgs = true;
+		for(int star = 0; star < spec.starCount; ++star)
+		{
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &stars[star], sizeof(int));
+		}
+
+		// Same spec with the length modifier swapped for one that matches the stored size
+		char specFormat[LOG_MAX_SPEC_LENGTH + 4];
+		size_t specLength = spec.modifierStart;
+		memcpy(specFormat, spec.start, specLength);
+
+		bool isShortInt = spec.modifierLength > 0 && spec.start[spec.modifierStart] == 'h';
+		if(spec.type == LOG_ARG_INT64)
+		{
+			specFormat[specLength++] = 'l';
+			specFormat[specLength++] = 'l';
+		}
+		else if(spec.type == LOG_ARG_INT32 && isShortInt)
+		{
+			memcpy(specFormat + specLength, spec.start + spec.modifierStart, spec.modifierLength);
+			specLength += spec.modifierLength;
+		}
+
+		char conversion = spec.start[spec.length - 1];
+		specFormat[specLength++] = (conversion == 'S') ? 's' : (conversion == 'C') ? 'c' : conversion;
+		specFormat[specLength] = '\0';
+
+		char* cursor = outText + length;
+		size_t room = length < capacity ? capacity - length : 0;
+		int written = 0;
+
+		switch(spec.type)
+		{
+		case LOG_ARG_INT32:
+		{
+			int32_t value = 0;
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &value, sizeof(value));
+			written = hasArgs ? FormatValue(cursor, room, specFormat, stars, spec.starCount, (int) value) : 0;
+			break;
+		}
+		case LOG_ARG_INT64:
+		{
+			int64_t value = 0;
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &value, sizeof(value));
+			written = hasArgs ? FormatValue(cursor, room, specFormat, stars, spec.starCount, (long long) value) : 0;
+			break;
+		}
+		case LOG_ARG_DOUBLE:
+		{
+			double value = 0.0;
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &value, sizeof(value));
+			written = hasArgs ? FormatValue(cursor, room, specFormat, stars, spec.starCount, value) : 0;
+			break;
+		}
+		case LOG_ARG_POINTER:
+		{
+			uint64_t value = 0;
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &value, sizeof(value));
+			written = hasArgs ? FormatValue(cursor, room, specFormat, stars, spec.starCount, (void*) (uintptr_t) value) : 0;
+			break;
+		}
+		case LOG_ARG_STRING:
+		case LOG_ARG_WIDE_STRING:
+		{
+			uint32_t stringLength = 0;
+			char value[LOG_MAX_MESSAGE_LENGTH];
+
+			hasArgs = hasArgs && ReadArgBytes(args, argsSize, &argOffset, &stringLength, sizeof(stringLength));
+			hasArgs = hasArgs && stringLength < LOG_MAX_MESSAGE_LENGTH && ReadArgBytes(args, argsSize, &argOffset, value, stringLength);
+			if(hasArgs)
+			{
+				value[stringLength] = '\0';
+				written = FormatValue(cursor, room, specFormat, stars, spec.starCount, (const char*) value);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		if(!hasArgs)
+		{
+			// Arguments were truncated when recording
+			AppendText(outText, capacity, &length, "?", 1);
+			continue;
+		}
+
+		if(written > 0 && room > 0)
+		{
+			length += (size_t) written < room ? (size_t) written : room - 1;
+		}
+	}
+
+	AppendText(outText, capacity, &length, format, strlen(format));
+	return length;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Expands a binary log into the "tag: text" text log format
+//
+bool LogDecodeBinaryFile(const char* binaryFileName, const char* textFileName)
+{
+	FILE* binaryFile = nullptr;
+	fopen_s(&binaryFile, binaryFileName, "rb");
+	if(binaryFile == nullptr)
+	{
+		return false;
+	}
+
+	fseek(binaryFile, 0L, SEEK_END);
+	size_t dataSize = (size_t) ftell(binaryFile);
+	fseek(binaryFile, 0L, SEEK_SET);
+
+	std::vector<char> data(dataSize);
+	dataSize = fread(data.data(), 1, dataSize, binaryFile);
+	fclose(binaryFile);
+
+	const char* bytes = data.data();
+	size_t offset = 0;
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	if(!ReadArgBytes(bytes, dataSize, &offset, &magic, sizeof(magic)) || !ReadArgBytes(bytes, dataSize, &offset, &version, sizeof(version))
+		|| magic != LOG_BINARY_MAGIC || version != LOG_BINARY_VERSION)
+	{
+		return false;
+	}
+
+	FILE* textFile = nullptr;
+	fopen_s(&textFile, textFileName, "w");
+	if(textFile == nullptr)
+	{
+		return false;
+	}
+
+	std::unordered_map<uint16_t, std::string> tags;
+	std::unordered_map<uint32_t, std::string> formats;
+	char text[LOG_MAX_MESSAGE_LENGTH];
+	bool isValid = true;
+
+	while(offset < dataSize && isValid)
+	{
+		uint8_t type = 0;
+		ReadArgBytes(bytes, dataSize, &offset, &type, sizeof(type));
+
+		switch(type)
+		{
+		case LOG_BINARY_TAG:
+		{
+			uint16_t tagId = 0;
+			uint16_t length = 0;
+			isValid = ReadArgBytes(bytes, dataSize, &offset, &tagId, sizeof(tagId)) && ReadArgBytes(bytes, dataSize, &offset, &length, sizeof(length))
+				&& offset + length <= dataSize;
+
+			if(isValid)
+			{
+				tags[tagId].assign(bytes + offset, length);
+				offset += length;
+			}
+			break;
+		}
+		case LOG_BINARY_FORMAT:
+		{
+			uint32_t formatId = 0;
+			uint32_t length = 0;
+			isValid = ReadArgBytes(bytes, dataSize, &offset, &formatId, sizeof(formatId)) && ReadArgBytes(bytes, dataSize, &offset, &length, sizeof(length))
+				&& offset + length <= dataSize;
+
+			if(isValid)
+			{
+				formats[formatId].assign(bytes + offset, length);
+				offset += length;
+			}
+			break;
+		}
+		case LOG_BINARY_MESSAGE:
+		{
+			uint16_t tagId = 0;
+			uint32_t formatId = 0;
+			uint32_t argsSize = 0;
+			isValid = ReadArgBytes(bytes, dataSize, &offset, &tagId, sizeof(tagId)) && ReadArgBytes(bytes, dataSize, &offset, &formatId, sizeof(formatId))
+				&& ReadArgBytes(bytes, dataSize, &offset, &argsSize, sizeof(argsSize)) && offset + argsSize <= dataSize;
+
+			if(isValid)
+			{
+				const std::string& tag = tags[tagId];
+				size_t textLength = LogBinaryFormatMessage(text, LOG_MAX_MESSAGE_LENGTH, formats[formatId].c_str(), bytes + offset, argsSize);
+
+				fwrite(tag.c_str(), 1, tag.size(), textFile);
+				fwrite(": ", 1, 2, textFile);
+				fwrite(text, 1, textLength, textFile);
+				offset += argsSize;
+			}
+			break;
+		}
+		default:
+			isValid = false; // Corrupt or truncated, keep what was decoded so far
+			break;
+		}
+	}
+
+	fclose(textFile);
+	return isValid;
+}
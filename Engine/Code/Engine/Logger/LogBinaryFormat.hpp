@@ -0,0 +1,40 @@
+#pragma once
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Binary log stream
+//
+// The file starts with LOG_BINARY_MAGIC and LOG_BINARY_VERSION (uint32 each), followed by records
+// that each start with a LogBinaryRecordType byte:
+//		LOG_BINARY_TAG		uint16 tagId, uint16 length, chars
+//		LOG_BINARY_FORMAT	uint32 formatId, uint32 length, chars
+//		LOG_BINARY_MESSAGE	uint16 tagId, uint32 formatId, uint32 argsSize, encoded args
+// Tags and formats are always defined before the first message that uses them
+#define LOG_BINARY_MAGIC		0x4C425754 // "TWBL"
+#define LOG_BINARY_VERSION		1
+
+enum LogBinaryRecordType : uint8_t
+{
+	LOG_BINARY_TAG = 1,
+	LOG_BINARY_FORMAT,
+	LOG_BINARY_MESSAGE
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+
+// Encodes the arguments the format string consumes: 4 byte ints, 8 byte ints/doubles/pointers and
+// length prefixed strings. Strings are truncated to fit. Returns the encoded size
+size_t	LogBinaryEncodeArgs( char* outArgs, size_t capacity, const char* format, va_list args );
+
+// Formats a message from encoded arguments, like vsnprintf would have. Returns the text length
+size_t	LogBinaryFormatMessage( char* outText, size_t capacity, const char* format, const char* args, size_t argsSize );
+
+// Expands a binary log into the "tag: text" text log format. Returns false if it can't be read
+bool	LogDecodeBinaryFile( const char* binaryFileName, const char* textFileName );
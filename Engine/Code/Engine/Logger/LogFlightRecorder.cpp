@@ -0,0 +1,455 @@
+#include "Engine/Logger/LogFlightRecorder.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Core/Time.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define FLIGHT_SLOT_COUNT		(LOG_FLIGHT_RECORDER_SIZE / LOG_FLIGHT_RECORDER_SLOT_SIZE - 1) // First slot holds the ring header
+#define FLIGHT_SLOT_BUSY		(~(uint64_t) 0) // Sequence of a slot being written
+
+//-----------------------------------------------------------------------------------------------
+// Types
+struct FlightRecorderHeader
+{
+	uint32_t				magic;
+	uint32_t				version;
+	uint32_t				slotSize;
+	uint32_t				slotCount;
+	std::atomic<uint64_t>	nextTicket;
+	std::atomic<uint32_t>	state;
+	std::atomic<uint32_t>	errorCount;
+	double					secondsPerCount; // So the dump can print times without this run's clock
+	uint64_t				startHpc;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct FlightRecorderSlot
+{
+	std::atomic<uint64_t>	sequence; // Ticket + 1 once written, zero if never written
+	uint64_t				hpc;
+	uint32_t				threadId;
+	uint16_t				type;
+	uint16_t				tagLength;
+	uint32_t				textLength;
+	uint32_t				reserved;
+};
+
+#define FLIGHT_SLOT_DATA_SIZE	(LOG_FLIGHT_RECORDER_SLOT_SIZE - sizeof(FlightRecorderSlot))
+
+static_assert(sizeof(FlightRecorderHeader) <= LOG_FLIGHT_RECORDER_SLOT_SIZE, "Flight recorder header must fit in one slot");
+static_assert(sizeof(FlightRecorderSlot) == 32, "Flight recorder slot headers are part of the file format");
+static_assert((LOG_FLIGHT_RECORDER_SLOT_SIZE & (LOG_FLIGHT_RECORDER_SLOT_SIZE - 1)) == 0, "Flight recorder slot size must be a power of two");
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static std::atomic<char*>		s_ring{nullptr};
+static std::atomic<uint64_t>	s_frameCount{0};
+
+#if defined(_WIN32)
+//-----------------------------------------------------------------------------------------------
+// Win32 Implementation
+//-----------------------------------------------------------------------------------------------
+#include "Engine/Core/Platform/Win32.hpp"
+
+static HANDLE	s_ringFile = INVALID_HANDLE_VALUE;
+static HANDLE	s_ringMapping = NULL;
+
+//-----------------------------------------------------------------------------------------------
+// Creates the ring file at its full size and maps it
+//
+static char* MapRingFile(const char* fileName, size_t size)
+{
+	s_ringFile = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(s_ringFile == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+
+	s_ringMapping = CreateFileMappingA(s_ringFile, NULL, PAGE_READWRITE, 0, (DWORD) size, NULL);
+	if(s_ringMapping == NULL)
+	{
+		CloseHandle(s_ringFile);
+		s_ringFile = INVALID_HANDLE_VALUE;
+		return nullptr;
+	}
+
+	char* ring = (char*) MapViewOfFile(s_ringMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(ring == nullptr)
+	{
+		CloseHandle(s_ringMapping);
+		CloseHandle(s_ringFile);
+		s_ringMapping = NULL;
+		s_ringFile = INVALID_HANDLE_VALUE;
+	}
+
+	return ring;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Blocks until the mapped pages are on disk
+//
+static void SyncRingFile(char* ring, size_t size)
+{
+	FlushViewOfFile(ring, size);
+	FlushFileBuffers(s_ringFile);
+}
+
+//-----------------------------------------------------------------------------------------------
+static void UnmapRingFile(char* ring, size_t size)
+{
+	UnmapViewOfFile(ring);
+	CloseHandle(s_ringMapping);
+	CloseHandle(s_ringFile);
+	s_ringMapping = NULL;
+	s_ringFile = INVALID_HANDLE_VALUE;
+
+	UNUSED(size);
+}
+
+#else
+//-----------------------------------------------------------------------------------------------
+// POSIX Implementation
+//-----------------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static int	s_ringFile = -1;
+
+//-----------------------------------------------------------------------------------------------
+// Creates the ring file at its full size and maps it
+//
+static char* MapRingFile(const char* fileName, size_t size)
+{
+	s_ringFile = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(s_ringFile < 0)
+	{
+		return nullptr;
+	}
+
+	void* ring = MAP_FAILED;
+	if(ftruncate(s_ringFile, (off_t) size) == 0)
+	{
+		ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, s_ringFile, 0);
+	}
+
+	if(ring == MAP_FAILED)
+	{
+		close(s_ringFile);
+		s_ringFile = -1;
+		return nullptr;
+	}
+
+	return (char*) ring;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Blocks until the mapped pages are on disk
+//
+static void SyncRingFile(char* ring, size_t size)
+{
+	msync(ring, size, MS_SYNC);
+}
+
+//-----------------------------------------------------------------------------------------------
+static void UnmapRingFile(char* ring, size_t size)
+{
+	munmap(ring, size);
+	close(s_ringFile);
+	s_ringFile = -1;
+}
+
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Returns the state a ring file was left in, 0 if there is no valid ring there
+//
+static uint32_t GetRingFileState(const char* ringFileName)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, ringFileName, "rb");
+	if(file == nullptr)
+	{
+		return 0;
+	}
+
+	uint32_t state = 0;
+	char headerBytes[sizeof(FlightRecorderHeader)];
+	if(fread(headerBytes, 1, sizeof(headerBytes), file) == sizeof(headerBytes))
+	{
+		const FlightRecorderHeader* header = (const FlightRecorderHeader*) headerBytes;
+		if(header->magic == FLIGHT_RECORDER_MAGIC && header->version == FLIGHT_RECORDER_VERSION)
+		{
+			state = header->state.load(std::memory_order_relaxed);
+		}
+	}
+
+	fclose(file);
+	return state;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Maps a fresh ring, dumping what a crashed run left in the old one first
+//
+bool FlightRecorderStartup(const char* ringFileName, const char* crashDumpFileName)
+{
+	if(s_ring.load(std::memory_order_acquire) != nullptr)
+	{
+		return true;
+	}
+
+	uint32_t previousState = GetRingFileState(ringFileName);
+	if(previousState == FLIGHT_STATE_RUNNING || previousState == FLIGHT_STATE_FATAL)
+	{
+		FlightRecorderDump(ringFileName, crashDumpFileName);
+	}
+
+	char* ring = MapRingFile(ringFileName, LOG_FLIGHT_RECORDER_SIZE);
+	if(ring == nullptr)
+	{
+		return false;
+	}
+
+	// Zeroed by the OS, so every slot starts out unwritten
+	FlightRecorderHeader* header = (FlightRecorderHeader*) ring;
+	header->magic = FLIGHT_RECORDER_MAGIC;
+	header->version = FLIGHT_RECORDER_VERSION;
+	header->slotSize = LOG_FLIGHT_RECORDER_SLOT_SIZE;
+	header->slotCount = FLIGHT_SLOT_COUNT;
+	header->nextTicket.store(0, std::memory_order_relaxed);
+	header->state.store(FLIGHT_STATE_RUNNING, std::memory_order_relaxed);
+	header->errorCount.store(0, std::memory_order_relaxed);
+	header->secondsPerCount = Time::HpcToSeconds(1);
+	header->startHpc = Time::GetPerformanceCounter();
+
+	s_ring.store(ring, std::memory_order_release);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Marks the ring clean so the next run doesn't treat it as a crash
+//
+void FlightRecorderShutdown()
+{
+	char* ring = s_ring.exchange(nullptr, std::memory_order_acq_rel);
+	if(ring == nullptr)
+	{
+		return;
+	}
+
+	FlightRecorderHeader* header = (FlightRecorderHeader*) ring;
+	if(header->state.load(std::memory_order_relaxed) == FLIGHT_STATE_RUNNING)
+	{
+		header->state.store(FLIGHT_STATE_CLEAN, std::memory_order_relaxed);
+	}
+
+	UnmapRingFile(ring, LOG_FLIGHT_RECORDER_SIZE);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool FlightRecorderIsRunning()
+{
+	return s_ring.load(std::memory_order_acquire) != nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Claims the next slot and copies the entry into it. The sequence is published last so the dump
+// can tell finished slots from ones a crash interrupted. If the ring has wrapped around onto a
+// writer that is still copying, the entry is dropped rather than mixed into its slot
+//
+void FlightRecorderWrite(FlightRecorderEntryType type, const char* tag, size_t tagLength, const char* text, size_t textLength)
+{
+	char* ring = s_ring.load(std::memory_order_acquire);
+	if(ring == nullptr)
+	{
+		return;
+	}
+
+	FlightRecorderHeader* header = (FlightRecorderHeader*) ring;
+	uint64_t ticket = header->nextTicket.fetch_add(1, std::memory_order_relaxed);
+
+	FlightRecorderSlot* slot = (FlightRecorderSlot*) (ring + LOG_FLIGHT_RECORDER_SLOT_SIZE * (1 + ticket % FLIGHT_SLOT_COUNT));
+	if(slot->sequence.exchange(FLIGHT_SLOT_BUSY, std::memory_order_acquire) == FLIGHT_SLOT_BUSY)
+	{
+		return;
+	}
+
+	tagLength = std::min(tagLength, (size_t) FLIGHT_SLOT_DATA_SIZE);
+	textLength = std::min(textLength, FLIGHT_SLOT_DATA_SIZE - tagLength);
+
+	char* data = (char*) (slot + 1);
+	memcpy(data, tag, tagLength);
+	memcpy(data + tagLength, text, textLength);
+
+	slot->hpc = Time::GetPerformanceCounter();
+	slot->threadId = (uint32_t) ThreadGetCurrentID();
+	slot->type = type;
+	slot->tagLength = (uint16_t) tagLength;
+	slot->textLength = (uint32_t) textLength;
+
+	slot->sequence.store(ticket + 1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the end of a profiler frame
+//
+void FlightRecorderMarkFrame(double frameMs)
+{
+	if(s_ring.load(std::memory_order_relaxed) == nullptr)
+	{
+		return;
+	}
+
+	char text[64];
+	int textLength = snprintf(text, sizeof(text), "frame %llu (%.2f ms)", (unsigned long long) s_frameCount.fetch_add(1, std::memory_order_relaxed), frameMs);
+	FlightRecorderWrite(FLIGHT_ENTRY_FRAME, "", 0, text, (size_t) textLength);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records an error. A fatal one also marks the ring and gets it onto disk, since the process is
+// about to go down
+//
+void FlightRecorderMarkError(const char* text, bool isFatal)
+{
+	char* ring = s_ring.load(std::memory_order_acquire);
+	if(ring == nullptr)
+	{
+		return;
+	}
+
+	FlightRecorderWrite(FLIGHT_ENTRY_ERROR, "", 0, text, strlen(text));
+
+	FlightRecorderHeader* header = (FlightRecorderHeader*) ring;
+	header->errorCount.fetch_add(1, std::memory_order_relaxed);
+
+	if(isFatal)
+	{
+		header->state.store(FLIGHT_STATE_FATAL, std::memory_order_relaxed);
+		SyncRingFile(ring, LOG_FLIGHT_RECORDER_SIZE);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes every finished slot of the ring oldest first. Returns false if it isn't a ring file
+//
+bool FlightRecorderDump(const char* ringFileName, const char* textFileName)
+{
+	FILE* ringFile = nullptr;
+	fopen_s(&ringFile, ringFileName, "rb");
+	if(ringFile == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<char> ring;
+	char buffer[64 * 1024];
+	size_t bytesRead;
+	while((bytesRead = fread(buffer, 1, sizeof(buffer), ringFile)) > 0)
+	{
+		ring.insert(ring.end(), buffer, buffer + bytesRead);
+	}
+	fclose(ringFile);
+
+	if(ring.size() < sizeof(FlightRecorderHeader))
+	{
+		return false;
+	}
+
+	const FlightRecorderHeader* header = (const FlightRecorderHeader*) ring.data();
+	if(header->magic != FLIGHT_RECORDER_MAGIC || header->version != FLIGHT_RECORDER_VERSION || header->slotSize < sizeof(FlightRecorderSlot)
+		|| (uint64_t) header->slotSize * (header->slotCount + 1) > ring.size())
+	{
+		return false;
+	}
+
+	// Finished slots, by sequence
+	std::vector<const FlightRecorderSlot*> slots;
+	for(uint32_t slotIndex = 0; slotIndex < header->slotCount; ++slotIndex)
+	{
+		const FlightRecorderSlot* slot = (const FlightRecorderSlot*) (ring.data() + (size_t) header->slotSize * (1 + slotIndex));
+		uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+		if(sequence != 0 && sequence != FLIGHT_SLOT_BUSY && slot->tagLength + slot->textLength <= header->slotSize - sizeof(FlightRecorderSlot))
+		{
+			slots.push_back(slot);
+		}
+	}
+
+	std::sort(slots.begin(), slots.end(), [](const FlightRecorderSlot* a, const FlightRecorderSlot* b)
+	{
+		return a->sequence.load(std::memory_order_relaxed) < b->sequence.load(std::memory_order_relaxed);
+	});
+
+	FILE* textFile = nullptr;
+	fopen_s(&textFile, textFileName, "w");
+	if(textFile == nullptr)
+	{
+		return false;
+	}
+
+	uint32_t state = header->state.load(std::memory_order_relaxed);
+	const char* stateName = state == FLIGHT_STATE_CLEAN ? "clean shutdown" : (state == FLIGHT_STATE_FATAL ? "fatal error" : "still running or crashed");
+
+	fprintf(textFile, "Flight recorder %s: %s, %u errors marked, %llu entries written, last %u kept\n", ringFileName, stateName,
+		header->errorCount.load(std::memory_order_relaxed), (unsigned long long) header->nextTicket.load(std::memory_order_relaxed), (unsigned) slots.size());
+
+	for(const FlightRecorderSlot* slot : slots)
+	{
+		const char* data = (const char*) (slot + 1);
+		double seconds = (double) (slot->hpc - header->startHpc) * header->secondsPerCount;
+
+		fprintf(textFile, "[%12.6f] [%08x] ", seconds, slot->threadId);
+
+		switch(slot->type)
+		{
+		case FLIGHT_ENTRY_FRAME:
+			fprintf(textFile, "==== %.*s ====\n", (int) slot->textLength, data);
+			break;
+
+		case FLIGHT_ENTRY_ERROR:
+		{
+			int errorLength = (int) slot->textLength;
+			while(errorLength > 0 && data[errorLength - 1] == '\n')
+			{
+				errorLength--;
+			}
+			fprintf(textFile, "!!!! ERROR: %.*s\n", errorLength, data);
+			break;
+		}
+
+		case FLIGHT_ENTRY_FORMAT:
+			fprintf(textFile, "%.*s: (binary, args not kept) %.*s", (int) slot->tagLength, data, (int) slot->textLength, data + slot->tagLength);
+			break;
+
+		default:
+			fprintf(textFile, "%.*s: %.*s", (int) slot->tagLength, data, (int) slot->textLength, data + slot->tagLength);
+			break;
+		}
+
+		// Messages carry their own newline unless they were truncated
+		if(slot->type == FLIGHT_ENTRY_MESSAGE || slot->type == FLIGHT_ENTRY_FORMAT)
+		{
+			const char* end = data + slot->tagLength + slot->textLength;
+			if(slot->textLength == 0 || end[-1] != '\n')
+			{
+				fputc('\n', textFile);
+			}
+		}
+	}
+
+	fclose(textFile);
+	return true;
+}
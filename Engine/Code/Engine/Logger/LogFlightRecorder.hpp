@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define FLIGHT_RECORDER_MAGIC		0x52474C46 // "FLGR"
+#define FLIGHT_RECORDER_VERSION		1
+
+//-----------------------------------------------------------------------------------------------
+enum FlightRecorderEntryType : uint16_t
+{
+	FLIGHT_ENTRY_MESSAGE = 1,	// "tag: text" as it was logged
+	FLIGHT_ENTRY_FORMAT,		// Binary mode message, only the format string is kept
+	FLIGHT_ENTRY_FRAME,			// Profiler frame marker
+	FLIGHT_ENTRY_ERROR			// GUARANTEE_OR_DIE, ERROR_AND_DIE and LogErrorf
+};
+
+//-----------------------------------------------------------------------------------------------
+enum FlightRecorderState : uint32_t
+{
+	FLIGHT_STATE_RUNNING = 1,	// Still the state after a crash
+	FLIGHT_STATE_CLEAN,			// Shut down normally
+	FLIGHT_STATE_FATAL			// Died on a fatal error
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+//
+// The flight recorder keeps the most recent log messages and profiler frames in a fixed size ring
+// of slots in a memory mapped file. Writers claim a slot with one atomic add and copy into it, the
+// OS writes the pages out even if the process crashes, so nothing waits on the logger thread
+
+// Maps ringFileName. A ring left behind by a run that didn't shut down cleanly is dumped to
+// crashDumpFileName first
+bool	FlightRecorderStartup( const char* ringFileName, const char* crashDumpFileName );
+void	FlightRecorderShutdown(); // Marks the ring clean
+bool	FlightRecorderIsRunning();
+
+// Writers, safe from any thread. Text longer than a slot is truncated
+void	FlightRecorderWrite( FlightRecorderEntryType type, const char* tag, size_t tagLength, const char* text, size_t textLength );
+void	FlightRecorderMarkFrame( double frameMs );
+void	FlightRecorderMarkError( const char* text, bool isFatal ); // Fatal marks are synced to disk before returning
+
+// Writes the entries of a ring file oldest first as text, works on live and crashed rings
+bool	FlightRecorderDump( const char* ringFileName, const char* textFileName );
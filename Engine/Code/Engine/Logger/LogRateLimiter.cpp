@@ -0,0 +1,108 @@
+#include "Engine/Logger/LogRateLimiter.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/Time.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+LogRateLimiter::LogRateLimiter()
+{
+	for(int tagId = 0; tagId < LOG_MAX_TAGS; ++tagId)
+	{
+		m_intervalHpc[tagId].store(0, std::memory_order_relaxed);
+		m_burstHpc[tagId].store(0, std::memory_order_relaxed);
+		m_messagesPerSecond[tagId].store(0, std::memory_order_relaxed);
+		m_burst[tagId].store(0, std::memory_order_relaxed);
+		m_fullHpc[tagId].store(0, std::memory_order_relaxed);
+		m_suppressed[tagId].store(0, std::memory_order_relaxed);
+		m_suppressedTotal[tagId].store(0, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lets messagesPerSecond through on average and up to burst at once
+//
+void LogRateLimiter::SetLimit(uint16_t tagId, int messagesPerSecond, int burst)
+{
+	if(tagId >= LOG_MAX_TAGS)
+	{
+		return;
+	}
+
+	if(messagesPerSecond <= 0)
+	{
+		m_intervalHpc[tagId].store(0, std::memory_order_relaxed);
+		m_messagesPerSecond[tagId].store(0, std::memory_order_relaxed);
+		m_burst[tagId].store(0, std::memory_order_relaxed);
+		return;
+	}
+
+	if(burst < 1)
+	{
+		burst = 1;
+	}
+
+	uint64_t intervalHpc = Time::SecondsToHpc(1.f / (float) messagesPerSecond);
+	if(intervalHpc == 0)
+	{
+		intervalHpc = 1;
+	}
+
+	m_messagesPerSecond[tagId].store(messagesPerSecond, std::memory_order_relaxed);
+	m_burst[tagId].store(burst, std::memory_order_relaxed);
+	m_burstHpc[tagId].store(intervalHpc * (uint64_t) (burst - 1), std::memory_order_relaxed);
+	m_fullHpc[tagId].store(0, std::memory_order_relaxed);
+	m_intervalHpc[tagId].store(intervalHpc, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes a token from the tag's bucket. Returns false and counts the message if there is none
+//
+bool LogRateLimiter::TryAcquire(uint16_t tagId)
+{
+	uint64_t intervalHpc = m_intervalHpc[tagId].load(std::memory_order_acquire);
+	if(intervalHpc == 0)
+	{
+		return true;
+	}
+
+	uint64_t burstHpc = m_burstHpc[tagId].load(std::memory_order_relaxed);
+	uint64_t nowHpc = Time::GetPerformanceCounter();
+	uint64_t fullHpc = m_fullHpc[tagId].load(std::memory_order_relaxed);
+
+	while(true)
+	{
+		if(fullHpc > nowHpc + burstHpc)
+		{
+			m_suppressed[tagId].fetch_add(1, std::memory_order_relaxed);
+			m_suppressedTotal[tagId].fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		uint64_t nextFullHpc = (fullHpc > nowHpc ? fullHpc : nowHpc) + intervalHpc;
+		if(m_fullHpc[tagId].compare_exchange_weak(fullHpc, nextFullHpc, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns how many messages were dropped since the last call
+//
+uint64_t LogRateLimiter::TakeSuppressed(uint16_t tagId)
+{
+	if(m_suppressed[tagId].load(std::memory_order_relaxed) == 0)
+	{
+		return 0;
+	}
+
+	return m_suppressed[tagId].exchange(0, std::memory_order_relaxed);
+}
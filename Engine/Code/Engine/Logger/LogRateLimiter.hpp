@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include "Engine/Core/EngineConfig.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Per tag token buckets, kept as the time the bucket would be full again (GCRA) so a check is one
+// compare and swap. Messages over the limit are dropped before they are formatted and counted
+class LogRateLimiter
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	LogRateLimiter();
+	~LogRateLimiter() {}
+
+	LogRateLimiter( const LogRateLimiter& ) = delete;
+	LogRateLimiter& operator=( const LogRateLimiter& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool		HasLimit( uint16_t tagId ) const { return tagId < LOG_MAX_TAGS && m_intervalHpc[tagId].load(std::memory_order_relaxed) != 0; }
+			int			GetMessagesPerSecond( uint16_t tagId ) const { return m_messagesPerSecond[tagId].load(std::memory_order_relaxed); }
+			int			GetBurst( uint16_t tagId ) const { return m_burst[tagId].load(std::memory_order_relaxed); }
+			uint64_t	GetSuppressedTotal( uint16_t tagId ) const { return m_suppressedTotal[tagId].load(std::memory_order_relaxed); }
+			void		SetLimit( uint16_t tagId, int messagesPerSecond, int burst ); // Zero messages per second removes the limit
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool		TryAcquire( uint16_t tagId ); // False if the message should be dropped
+			uint64_t	TakeSuppressed( uint16_t tagId ); // Dropped since the last call
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::atomic<uint64_t>	m_intervalHpc[LOG_MAX_TAGS]; // Zero means unlimited, read on every log call
+	std::atomic<uint64_t>	m_burstHpc[LOG_MAX_TAGS]; // How far ahead of now the bucket may run
+	std::atomic<int>		m_messagesPerSecond[LOG_MAX_TAGS];
+	std::atomic<int>		m_burst[LOG_MAX_TAGS];
+	std::atomic<uint64_t>	m_fullHpc[LOG_MAX_TAGS]; // Theoretical arrival time of the next message
+	std::atomic<uint64_t>	m_suppressed[LOG_MAX_TAGS];
+	std::atomic<uint64_t>	m_suppressedTotal[LOG_MAX_TAGS];
+};
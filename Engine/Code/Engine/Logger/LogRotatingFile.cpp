@@ -0,0 +1,281 @@
+#include "Engine/Logger/LogRotatingFile.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/MPSCQueue.hpp"
+#include "Engine/Async/Signal.hpp"
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Logger/Logger.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <atomic>
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Types
+struct LogArchiveJob
+{
+	std::string	path;
+	bool		isDelete = false; // Otherwise compress it
+};
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static MPSCQueue<LogArchiveJob, LOG_ARCHIVE_QUEUE_SIZE>	s_archiveJobs;
+static Signal					s_archiveSignal;
+static std::atomic<bool>		s_isArchiverRunning{false};
+static ThreadHandle				s_archiverThread = nullptr;
+
+//-----------------------------------------------------------------------------------------------
+// Queues work for the archiver thread. Jobs run in order, so a segment is compressed before it
+// can be deleted. Returns false if the archiver is too far behind to take it
+//
+static bool LogArchiverEnqueue(const std::string& path, bool isDelete)
+{
+	LogArchiveJob job;
+	job.path = path;
+	job.isDelete = isDelete;
+
+	bool wasQueued = s_archiveJobs.Enqueue(job);
+	s_archiveSignal.Notify();
+	return wasQueued;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Compresses or deletes one segment
+//
+static void LogArchiverRunJob(const LogArchiveJob& job)
+{
+	std::string gzipPath = job.path + ".gz";
+	if(job.isDelete)
+	{
+		// A segment that failed to compress was kept as is, so either name may exist
+		remove(gzipPath.c_str());
+		remove(job.path.c_str());
+		return;
+	}
+
+	if(FileCompressToGzip(job.path.c_str(), gzipPath.c_str()))
+	{
+		remove(job.path.c_str());
+	}
+	else
+	{
+		remove(gzipPath.c_str()); // Keep the uncompressed segment rather than a broken archive
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Archiver thread. Sleeps until segments are queued
+//
+static void LogArchiverWorker(void* userData)
+{
+	while(true)
+	{
+		LogArchiveJob job;
+		while(s_archiveJobs.Dequeue(&job))
+		{
+			LogArchiverRunJob(job);
+		}
+
+		if(!s_isArchiverRunning.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		uint64_t epoch = s_archiveSignal.PrepareWait();
+		if(!s_archiveJobs.IsEmpty() || !s_isArchiverRunning.load(std::memory_order_acquire))
+		{
+			s_archiveSignal.CancelWait();
+		}
+		else
+		{
+			s_archiveSignal.Wait(epoch);
+		}
+	}
+
+	UNUSED(userData);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts the archiver thread below the logger's priority and off the main thread's core
+//
+void LogArchiverStartup()
+{
+	s_isArchiverRunning.store(true, std::memory_order_release);
+	s_archiverThread = ThreadCreate("Log Archiver Thread", LogArchiverWorker, nullptr);
+
+	uint64_t archiverCores = ThreadGetAllCoresMask() & ~((uint64_t) 1 << ENGINE_MAIN_THREAD_CORE);
+	if(archiverCores != 0)
+	{
+		ThreadSetAffinity(s_archiverThread, archiverCores);
+	}
+	ThreadSetPriority(s_archiverThread, THREAD_PRIO_LOWEST);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stops the archiver thread once everything queued is done
+//
+void LogArchiverShutdown()
+{
+	if(s_archiverThread == nullptr)
+	{
+		return;
+	}
+
+	s_isArchiverRunning.store(false, std::memory_order_release);
+	s_archiveSignal.Notify();
+
+	ThreadJoin(s_archiverThread);
+	s_archiverThread = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+LogRotatingFile::LogRotatingFile(const std::string& basePath, const char* extension, FileMode mode)
+	: m_basePath(basePath)
+	, m_extension(extension)
+	, m_mode(mode)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+LogRotatingFile::~LogRotatingFile()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true once the active segment has data and is over the size or age limit, or once a
+// segment that couldn't be created can be tried again
+//
+bool LogRotatingFile::ShouldRotate() const
+{
+	if(m_file == nullptr)
+	{
+		return m_retryOpenHpc != 0 && Time::GetPerformanceCounter() >= m_retryOpenHpc;
+	}
+
+	if(m_segmentSize == 0)
+	{
+		return false;
+	}
+
+	return m_segmentSize >= LOG_ROTATE_MAX_BYTES || Time::HpcToSeconds(Time::GetPerformanceCounter() - m_segmentOpenHpc) >= LOG_ROTATE_MAX_SECONDS;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts the next segment. Returns false if it can't be created, the same name is tried again
+// after LOG_REOPEN_RETRY_SECONDS
+//
+bool LogRotatingFile::Open()
+{
+	Close();
+
+	char segmentSuffix[16];
+	snprintf(segmentSuffix, sizeof(segmentSuffix), "_%03u", m_nextSegmentIndex);
+	m_segmentPath = m_basePath + segmentSuffix + m_extension;
+	m_nextSegmentIndex++;
+
+	m_file = new File();
+	if(m_file->Open(m_segmentPath.c_str(), m_mode) != 0) // fopen error codes
+	{
+		delete m_file;
+		m_file = nullptr;
+		m_nextSegmentIndex--;
+		m_retryOpenHpc = Time::GetPerformanceCounter() + Time::SecondsToHpc((float) LOG_REOPEN_RETRY_SECONDS);
+
+		// Logged from the logger thread, so it reaches the hooks and any other log that is still open
+		if(!m_hasReportedOpenFailure)
+		{
+			LogWarningf("Couldn't create log segment '%s', retrying every %d seconds", m_segmentPath.c_str(), LOG_REOPEN_RETRY_SECONDS);
+			m_hasReportedOpenFailure = true;
+		}
+		return false;
+	}
+
+	m_retryOpenHpc = 0;
+	m_hasReportedOpenFailure = false;
+	m_segmentSize = 0;
+	m_segmentOpenHpc = Time::GetPerformanceCounter();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Closes the active segment and leaves it where it is
+//
+void LogRotatingFile::Close()
+{
+	if(m_file != nullptr)
+	{
+		m_file->Close();
+		delete m_file;
+		m_file = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hands the active segment to the archiver and starts the next one
+//
+bool LogRotatingFile::Rotate()
+{
+	if(m_file == nullptr)
+	{
+		return Open();
+	}
+
+	Close();
+
+	m_archivedSegments.push_back(m_segmentPath);
+
+	// Deletes are queued first so a backed up archiver still keeps the retention limit. The ones it
+	// can't take yet are retried on the next rotation
+	while(m_archivedSegments.size() > LOG_MAX_RETAINED_SEGMENTS && LogArchiverEnqueue(m_archivedSegments.front(), true))
+	{
+		m_archivedSegments.pop_front();
+	}
+
+#if defined( LOG_COMPRESS_SEGMENTS )
+	LogArchiverEnqueue(m_segmentPath, false); // Left uncompressed if the archiver is backed up
+#endif
+
+	return Open();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends to the active segment
+//
+void LogRotatingFile::WriteGather(const FileWriteSpan* spans, size_t count)
+{
+	if(m_file == nullptr)
+	{
+		return;
+	}
+
+	m_file->WriteGather(spans, count);
+
+	for(size_t spanIndex = 0; spanIndex < count; ++spanIndex)
+	{
+		m_segmentSize += spans[spanIndex].size;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Gets the active segment onto disk
+//
+void LogRotatingFile::Flush()
+{
+	if(m_file != nullptr)
+	{
+		m_file->Flush();
+	}
+}
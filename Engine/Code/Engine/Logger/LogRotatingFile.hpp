@@ -0,0 +1,63 @@
+#pragma once
+#include <deque>
+#include <stdint.h>
+#include <string>
+#include "Engine/Enumerations/FileMode.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class File;
+struct FileWriteSpan;
+
+//-----------------------------------------------------------------------------------------------
+// Log file written in segments named <basePath>_000<extension>, <basePath>_001<extension>... The
+// writer only ever appends to the small active segment. Rotated segments go to the archiver thread,
+// which compresses them and deletes the oldest past LOG_MAX_RETAINED_SEGMENTS
+class LogRotatingFile
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	LogRotatingFile( const std::string& basePath, const char* extension, FileMode mode );
+	~LogRotatingFile();
+
+	LogRotatingFile( const LogRotatingFile& ) = delete;
+	LogRotatingFile& operator=( const LogRotatingFile& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool				IsOpen() const { return m_file != nullptr; }
+			bool				ShouldRotate() const; // Active segment is too big or too old, or a segment that couldn't be created is due another try
+			bool				HasFailedOpen() const { return m_retryOpenHpc != 0; } // Open is retried by Rotate once ShouldRotate says so
+			const std::string&	GetSegmentPath() const { return m_segmentPath; }
+			uint64_t			GetSegmentSize() const { return m_segmentSize; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool				Open(); // Starts the next segment
+			void				Close(); // Closes the active segment and leaves it uncompressed
+			bool				Rotate(); // Closes and archives the active segment, then starts the next one
+			void				WriteGather( const FileWriteSpan* spans, size_t count );
+			void				Flush();
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::string				m_basePath;
+	std::string				m_extension;
+	FileMode				m_mode;
+	File*					m_file = nullptr;
+	std::string				m_segmentPath;
+	uint32_t				m_nextSegmentIndex = 0;
+	uint64_t				m_segmentSize = 0;
+	uint64_t				m_segmentOpenHpc = 0;
+	uint64_t				m_retryOpenHpc = 0; // Non zero while the segment couldn't be created, when to try again
+	bool					m_hasReportedOpenFailure = false; // Reported once until a segment opens again
+	std::deque<std::string>	m_archivedSegments; // Oldest first, uncompressed names. Deleting one removes its .gz as well
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+
+// Low priority thread that compresses and deletes rotated segments
+void LogArchiverStartup();
+void LogArchiverShutdown(); // Finishes the queued work first
@@ -0,0 +1,186 @@
+#include "Engine/Logger/LogTagRegistry.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+LogTagRegistry::LogTagRegistry()
+	: m_internLock("LogTags")
+{
+	for(std::atomic<uint64_t>& bits : m_enabledBits)
+	{
+		bits.store(~(uint64_t) 0, std::memory_order_relaxed);
+	}
+
+	for(std::atomic<uint16_t>& slot : m_slots)
+	{
+		slot.store(0, std::memory_order_relaxed);
+	}
+
+	memset(m_names, 0, sizeof(m_names));
+	memset(m_nameLengths, 0, sizeof(m_nameLengths));
+	memset(m_hashes, 0, sizeof(m_hashes));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+LogTagRegistry::~LogTagRegistry()
+{
+	uint32_t count = m_count.load(std::memory_order_acquire);
+	for(uint32_t tagId = 0; tagId < count; ++tagId)
+	{
+		delete[] m_names[tagId];
+		m_names[tagId] = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if messages with this tag should be logged
+//
+bool LogTagRegistry::IsEnabled(uint16_t tagId) const
+{
+	if(tagId >= LOG_MAX_TAGS)
+	{
+		return m_isEnabledByDefault.load(std::memory_order_relaxed);
+	}
+
+	return (m_enabledBits[tagId / 64].load(std::memory_order_relaxed) & ((uint64_t) 1 << (tagId % 64))) != 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets or clears the tag's enabled bit
+//
+void LogTagRegistry::SetEnabled(uint16_t tagId, bool isEnabled)
+{
+	if(tagId >= LOG_MAX_TAGS)
+	{
+		return;
+	}
+
+	uint64_t bit = (uint64_t) 1 << (tagId % 64);
+	if(isEnabled)
+	{
+		m_enabledBits[tagId / 64].fetch_or(bit, std::memory_order_relaxed);
+	}
+	else
+	{
+		m_enabledBits[tagId / 64].fetch_and(~bit, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets every tag's enabled bit, including the ones of tags that have not been logged yet
+//
+void LogTagRegistry::SetAllEnabled(bool isEnabled)
+{
+	m_internLock.Enter();
+
+	m_isEnabledByDefault.store(isEnabled, std::memory_order_relaxed);
+	for(std::atomic<uint64_t>& bits : m_enabledBits)
+	{
+		bits.store(isEnabled ? ~(uint64_t) 0 : 0, std::memory_order_relaxed);
+	}
+
+	m_internLock.Leave();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the tag's ID, registering it the first time it is seen
+//
+uint16_t LogTagRegistry::Intern(const char* tag)
+{
+	size_t tagLength;
+	uint32_t hash = HashTag(tag, &tagLength);
+
+	uint16_t tagId = Find(tag, tagLength, hash);
+	if(tagId != LOG_INVALID_TAG_ID)
+	{
+		return tagId;
+	}
+
+	m_internLock.Enter();
+
+	// Someone may have registered it while we waited
+	tagId = Find(tag, tagLength, hash);
+	uint32_t count = m_count.load(std::memory_order_relaxed);
+
+	if(tagId == LOG_INVALID_TAG_ID && count < LOG_MAX_TAGS)
+	{
+		tagId = (uint16_t) count;
+
+		char* name = new char[tagLength + 1];
+		memcpy(name, tag, tagLength);
+		name[tagLength] = '\0';
+
+		m_names[tagId] = name;
+		m_nameLengths[tagId] = (uint16_t) tagLength;
+		m_hashes[tagId] = hash;
+		SetEnabled(tagId, m_isEnabledByDefault.load(std::memory_order_relaxed));
+
+		// Publishing the slot makes the name visible to lock free lookups
+		for(uint32_t probe = 0; probe < LOG_TAG_SLOT_COUNT; ++probe)
+		{
+			std::atomic<uint16_t>& slot = m_slots[(hash + probe) & (LOG_TAG_SLOT_COUNT - 1)];
+			if(slot.load(std::memory_order_relaxed) == 0)
+			{
+				slot.store((uint16_t) (tagId + 1), std::memory_order_release);
+				break;
+			}
+		}
+
+		m_count.store(count + 1, std::memory_order_release);
+	}
+
+	m_internLock.Leave();
+	return tagId;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the ID of an already registered tag, or LOG_INVALID_TAG_ID
+//
+uint16_t LogTagRegistry::Find(const char* tag, size_t tagLength, uint32_t hash) const
+{
+	for(uint32_t probe = 0; probe < LOG_TAG_SLOT_COUNT; ++probe)
+	{
+		uint16_t entry = m_slots[(hash + probe) & (LOG_TAG_SLOT_COUNT - 1)].load(std::memory_order_acquire);
+		if(entry == 0)
+		{
+			break;
+		}
+
+		uint16_t tagId = entry - 1;
+		if(m_hashes[tagId] == hash && m_nameLengths[tagId] == tagLength && memcmp(m_names[tagId], tag, tagLength) == 0)
+		{
+			return tagId;
+		}
+	}
+
+	return LOG_INVALID_TAG_ID;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FNV-1a over the tag, up to LOG_MAX_TAG_LENGTH characters
+//
+uint32_t LogTagRegistry::HashTag(const char* tag, size_t* outTagLength)
+{
+	uint32_t hash = 2166136261u;
+	size_t length = 0;
+
+	while(length < LOG_MAX_TAG_LENGTH && tag[length] != '\0')
+	{
+		hash = (hash ^ (uint8_t) tag[length]) * 16777619u;
+		length++;
+	}
+
+	*outTagLength = length;
+	return hash;
+}
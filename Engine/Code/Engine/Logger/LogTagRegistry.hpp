@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "Engine/Async/Spinlock.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define LOG_INVALID_TAG_ID		0xFFFF // Registry is full. Such tags use the default enabled state
+#define LOG_TAG_SLOT_COUNT		(LOG_MAX_TAGS * 2) // Open addressed hash slots, a power of two
+
+//-----------------------------------------------------------------------------------------------
+// Interns log tags into small IDs the first time they are logged and keeps one enabled bit per ID.
+// Lookups and enabled checks are lock free, only interning a new tag takes the lock
+class LogTagRegistry
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	LogTagRegistry();
+	~LogTagRegistry();
+
+	LogTagRegistry( const LogTagRegistry& ) = delete;
+	LogTagRegistry& operator=( const LogTagRegistry& ) = delete;
+	ALIGNED_NEW_AND_DELETE(LogTagRegistry) // Its lock is cache line aligned
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			const char*	GetName( uint16_t tagId ) const { return m_names[tagId]; }
+			size_t		GetNameLength( uint16_t tagId ) const { return m_nameLengths[tagId]; }
+			bool		IsEnabled( uint16_t tagId ) const;
+			void		SetEnabled( uint16_t tagId, bool isEnabled );
+			void		SetAllEnabled( bool isEnabled ); // Also the state of tags interned later
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			uint16_t	Intern( const char* tag ); // Tags longer than LOG_MAX_TAG_LENGTH are truncated
+			uint16_t	Find( const char* tag, size_t tagLength, uint32_t hash ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Static methods
+	static	uint32_t	HashTag( const char* tag, size_t* outTagLength );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::atomic<uint64_t>	m_enabledBits[(LOG_MAX_TAGS + 63) / 64];
+	std::atomic<bool>		m_isEnabledByDefault{true};
+	std::atomic<uint16_t>	m_slots[LOG_TAG_SLOT_COUNT]; // Tag ID + 1, zero when empty
+	std::atomic<uint32_t>	m_count{0};
+	char*					m_names[LOG_MAX_TAGS];
+	uint16_t				m_nameLengths[LOG_MAX_TAGS];
+	uint32_t				m_hashes[LOG_MAX_TAGS];
+	Spinlock				m_internLock;
+};
@@ -0,0 +1,371 @@
+#include "Engine/Logger/LogThreadBuffer.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Logger/LogBinaryFormat.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdio.h>
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define LOG_RECORD_ALIGNMENT	16 // Header size, so a padding header always fits at the end of the ring
+#define LOG_RECORD_PADDING		0x1 // Fills the end of the ring when a record does not fit there
+#define LOG_RECORD_BINARY		0x2 // Format pointer and encoded args instead of a formatted line
+#define LOG_RECORD_REPEAT		0x4 // Header only, the previous record was repeated lineLength times
+
+//-----------------------------------------------------------------------------------------------
+// Types
+struct LogRecordHeader
+{
+	uint32_t	size;		// Whole record including this header, aligned
+	uint32_t	lineLength;	// Encoded args size for binary records
+	uint16_t	tagLength;
+	uint16_t	flags;
+	uint16_t	tagId;
+	uint16_t	reserved;
+};
+
+static_assert(sizeof(LogRecordHeader) == LOG_RECORD_ALIGNMENT, "Log record headers must fill one alignment unit");
+
+//-----------------------------------------------------------------------------------------------
+// Rounds a record size up so every header stays aligned
+//
+static inline size_t AlignRecordSize(size_t size)
+{
+	return (size + LOG_RECORD_ALIGNMENT - 1) & ~((size_t) LOG_RECORD_ALIGNMENT - 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// FNV-1a over the tag ID and the record's payload
+//
+static uint64_t HashRecord(uint16_t tagId, const char* payload, size_t payloadSize)
+{
+	uint64_t hash = 14695981039346656037ULL ^ tagId;
+	hash *= 1099511628211ULL;
+
+	for(size_t byteIndex = 0; byteIndex < payloadSize; ++byteIndex)
+	{
+		hash ^= (uint8_t) payload[byteIndex];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Fills record from a committed record, which must not be padding
+//
+static void ParseRecord(const LogRecordHeader* header, LogRecord& record)
+{
+	const char* payload = (const char*) (header + 1);
+
+	record.tagId = header->tagId;
+	record.repeatCount = 0;
+	record.isBinaryRepeat = false;
+
+	if(header->flags & LOG_RECORD_REPEAT)
+	{
+		record.tag = nullptr;
+		record.tagLength = 0;
+		record.line = nullptr;
+		record.lineLength = 0;
+		record.format = nullptr;
+		record.args = nullptr;
+		record.argsSize = 0;
+		record.repeatCount = header->lineLength;
+		record.isBinaryRepeat = (header->flags & LOG_RECORD_BINARY) != 0;
+	}
+	else if(header->flags & LOG_RECORD_BINARY)
+	{
+		size_t argsOffset = sizeof(const char*);
+		memcpy(&record.format, payload, sizeof(const char*));
+
+		record.tag = nullptr;
+		record.tagLength = 0;
+		record.line = nullptr;
+		record.lineLength = 0;
+		record.args = payload + argsOffset;
+		record.argsSize = header->lineLength;
+	}
+	else
+	{
+		record.tag = payload;
+		record.tagLength = header->tagLength;
+		record.line = payload;
+		record.lineLength = header->lineLength;
+		record.format = nullptr;
+		record.args = nullptr;
+		record.argsSize = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+LogThreadBuffer::LogThreadBuffer(size_t capacity, uintptr_t threadId)
+	: m_capacity(capacity)
+	, m_threadId(threadId)
+{
+	GUARANTEE_OR_DIE((capacity & (capacity - 1)) == 0, "Log thread buffer capacity must be a power of two");
+	m_data = new char[capacity];
+
+#if defined( LOG_COLLAPSE_REPEATS )
+	m_repeatWindowHpc = Time::SecondsToHpc(LOG_REPEAT_WINDOW_MS / 1000.f); // LogSystemStartup creates Time before any thread can log
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+LogThreadBuffer::~LogThreadBuffer()
+{
+	delete[] m_data;
+	m_data = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the owner has committed records the logger has not released yet
+//
+bool LogThreadBuffer::HasPendingRecords() const
+{
+	return m_writePos.load(std::memory_order_acquire) != m_readPos.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Formats "tag: text" straight into the ring. Space for the longest message is reserved up front
+// so the record is always contiguous
+//
+bool LogThreadBuffer::TryAppend(uint16_t tagId, const char* tag, const char* format, va_list args)
+{
+	size_t tagLength = strlen(tag);
+	if(tagLength > LOG_MAX_TAG_LENGTH)
+	{
+		tagLength = LOG_MAX_TAG_LENGTH;
+	}
+
+	LogRecordHeader* header = (LogRecordHeader*) ReserveRecord(sizeof(LogRecordHeader) + AlignRecordSize(sizeof(LogRecordHeader) + tagLength + 2 + LOG_MAX_MESSAGE_LENGTH));
+	if(header == nullptr)
+	{
+		return false;
+	}
+
+	char* line = (char*) (header + 1);
+
+	memcpy(line, tag, tagLength);
+	line[tagLength] = ':';
+	line[tagLength + 1] = ' ';
+
+	int textLength = vsnprintf(line + tagLength + 2, LOG_MAX_MESSAGE_LENGTH, format, args);
+	if(textLength < 0)
+	{
+		textLength = 0;
+	}
+	else if(textLength >= LOG_MAX_MESSAGE_LENGTH)
+	{
+		textLength = LOG_MAX_MESSAGE_LENGTH - 1; // Truncated
+	}
+
+	header->lineLength = (uint32_t) (tagLength + 2 + textLength);
+	header->tagLength = (uint16_t) tagLength;
+	header->flags = 0;
+	header->tagId = tagId;
+	header->size = (uint32_t) AlignRecordSize(sizeof(LogRecordHeader) + header->lineLength);
+
+	CommitOrCollapse((char*) header, line, header->lineLength);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stores the tag ID, the format pointer and the encoded arguments. Nothing is formatted here, the
+// logger thread or the decoder does that later
+//
+bool LogThreadBuffer::TryAppendBinary(uint16_t tagId, const char* format, va_list args)
+{
+	size_t argsOffset = sizeof(const char*);
+	LogRecordHeader* header = (LogRecordHeader*) ReserveRecord(sizeof(LogRecordHeader) + AlignRecordSize(sizeof(LogRecordHeader) + argsOffset + LOG_MAX_MESSAGE_LENGTH));
+	if(header == nullptr)
+	{
+		return false;
+	}
+
+	char* payload = (char*) (header + 1);
+	memcpy(payload, &format, sizeof(const char*));
+
+	size_t argsSize = LogBinaryEncodeArgs(payload + argsOffset, LOG_MAX_MESSAGE_LENGTH, format, args);
+
+	header->lineLength = (uint32_t) argsSize;
+	header->tagLength = 0;
+	header->flags = LOG_RECORD_BINARY;
+	header->tagId = tagId;
+	header->size = (uint32_t) AlignRecordSize(sizeof(LogRecordHeader) + argsOffset + argsSize);
+
+	CommitOrCollapse((char*) header, payload, argsOffset + argsSize);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reserves maxRecordSize contiguous bytes, padding out the end of the ring if they don't fit there
+//
+char* LogThreadBuffer::ReserveRecord(size_t maxRecordSize)
+{
+	size_t writePos = m_writePos.load(std::memory_order_relaxed);
+	size_t readPos = m_readPos.load(std::memory_order_acquire);
+
+	size_t offset = writePos & (m_capacity - 1);
+	size_t tailRoom = m_capacity - offset;
+	size_t padding = tailRoom < maxRecordSize ? tailRoom : 0;
+
+	if(writePos + padding + maxRecordSize - readPos > m_capacity)
+	{
+		return nullptr;
+	}
+
+	if(padding > 0)
+	{
+		LogRecordHeader* paddingHeader = (LogRecordHeader*) (m_data + offset);
+		paddingHeader->size = (uint32_t) padding;
+		paddingHeader->lineLength = 0;
+		paddingHeader->tagLength = 0;
+		paddingHeader->flags = LOG_RECORD_PADDING;
+		offset = 0;
+	}
+
+	m_reservePos = writePos + padding;
+	return m_data + offset;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Publishes the record written into the last reservation
+//
+void LogThreadBuffer::CommitRecord(size_t recordSize)
+{
+	m_writePos.store(m_reservePos + recordSize, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Commits the record just written unless it repeats the last one inside the repeat window, in
+// which case it is dropped and counted. Repeats are written as a marker in front of the next
+// different record, the reservation always leaves room for one
+//
+void LogThreadBuffer::CommitOrCollapse(char* record, const char* payload, size_t payloadSize)
+{
+	LogRecordHeader* header = (LogRecordHeader*) record;
+
+#if defined( LOG_COLLAPSE_REPEATS )
+	uint64_t hash = HashRecord(header->tagId, payload, payloadSize);
+	uint64_t nowHpc = Time::GetPerformanceCounter();
+
+	if(hash == m_lastHash && nowHpc - m_lastHpc.load(std::memory_order_relaxed) < m_repeatWindowHpc)
+	{
+		uint64_t tagBits = ((uint64_t) header->tagId << LOG_REPEAT_TAG_SHIFT) | ((header->flags & LOG_RECORD_BINARY) ? LOG_REPEAT_BINARY_BIT : 0);
+		uint64_t pending = m_pendingRepeats.load(std::memory_order_relaxed);
+		while(!m_pendingRepeats.compare_exchange_weak(pending, (pending == 0 ? tagBits : pending) + 1, std::memory_order_acq_rel))
+		{
+		}
+
+		m_lastRecord = nullptr;
+		return;
+	}
+
+	m_lastHash = hash;
+	m_lastHpc.store(nowHpc, std::memory_order_relaxed);
+
+	uint64_t pending = m_pendingRepeats.exchange(0, std::memory_order_acq_rel);
+	if(pending != 0)
+	{
+		size_t recordSize = header->size;
+		memmove(record + sizeof(LogRecordHeader), record, recordSize);
+
+		LogRecordHeader* marker = header;
+		marker->size = sizeof(LogRecordHeader);
+		marker->lineLength = (uint32_t) (pending & LOG_REPEAT_COUNT_MASK);
+		marker->tagLength = 0;
+		marker->flags = LOG_RECORD_REPEAT | ((pending & LOG_REPEAT_BINARY_BIT) ? LOG_RECORD_BINARY : 0);
+		marker->tagId = (uint16_t) (pending >> LOG_REPEAT_TAG_SHIFT);
+
+		m_lastRecord = record + sizeof(LogRecordHeader);
+		CommitRecord(sizeof(LogRecordHeader) + recordSize);
+		return;
+	}
+#else
+	UNUSED(payload);
+	UNUSED(payloadSize);
+#endif
+
+	m_lastRecord = record;
+	CommitRecord(header->size);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the record the owner just appended. Only the owner writes the ring, so it stays intact
+// until the owner appends again even if the logger has already released it
+//
+bool LogThreadBuffer::GetLastRecord(LogRecord& outRecord) const
+{
+	if(m_lastRecord == nullptr)
+	{
+		return false;
+	}
+
+	ParseRecord((const LogRecordHeader*) m_lastRecord, outRecord);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends every committed record to outRecords and returns how many were added
+//
+size_t LogThreadBuffer::ReadRecords(std::vector<LogRecord>& outRecords)
+{
+	size_t readPos = m_readPos.load(std::memory_order_relaxed);
+	size_t writePos = m_writePos.load(std::memory_order_acquire);
+	size_t count = 0;
+
+	while(readPos != writePos)
+	{
+		const LogRecordHeader* header = (const LogRecordHeader*) (m_data + (readPos & (m_capacity - 1)));
+
+		if((header->flags & LOG_RECORD_PADDING) == 0)
+		{
+			LogRecord record;
+			ParseRecord(header, record);
+
+			outRecords.push_back(record);
+			count++;
+		}
+
+		readPos += header->size;
+	}
+
+	m_pendingReadPos = writePos;
+	return count;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the repeat count once the repeat window of the last record has passed, so a thread that
+// stopped logging still gets its repeats reported
+//
+uint64_t LogThreadBuffer::TakeExpiredRepeats(uint64_t nowHpc, uint64_t windowHpc)
+{
+	if(m_pendingRepeats.load(std::memory_order_relaxed) == 0 || nowHpc - m_lastHpc.load(std::memory_order_relaxed) < windowHpc)
+	{
+		return 0;
+	}
+
+	return m_pendingRepeats.exchange(0, std::memory_order_acq_rel);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lets the owner reuse everything returned by the last ReadRecords
+//
+void LogThreadBuffer::Release()
+{
+	m_readPos.store(m_pendingReadPos, std::memory_order_release);
+}
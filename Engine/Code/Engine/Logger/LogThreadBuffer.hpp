@@ -0,0 +1,94 @@
+#pragma once
+#pragma warning (disable:4324) // Padding from alignas is wanted
+#include <atomic>
+#include <stdarg.h>
+#include <stdint.h>
+#include <vector>
+#include "Engine/Core/AlignedAllocation.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// A record as the consumer sees it. Points into the buffer until Release is called
+struct LogRecord
+{
+	uint16_t	tagId;
+	const char*	tag; // Null for binary records, the logger looks the name up by ID
+	size_t		tagLength;
+	const char*	line; // "tag: text", exactly what goes into the log file. Null for binary records
+	size_t		lineLength;
+	const char*	format; // Binary records only, formatting is left to whoever reads them
+	const char*	args; // Encoded with LogBinaryEncodeArgs
+	size_t		argsSize;
+	uint64_t	repeatCount; // Non zero for repeat markers, the thread's previous record was repeated this many times
+	bool		isBinaryRepeat; // The repeated record was binary
+};
+
+//-----------------------------------------------------------------------------------------------
+// Packing of LogThreadBuffer::m_pendingRepeats
+#define LOG_REPEAT_TAG_SHIFT		48
+#define LOG_REPEAT_BINARY_BIT		((uint64_t) 1 << 47)
+#define LOG_REPEAT_COUNT_MASK		(LOG_REPEAT_BINARY_BIT - 1)
+
+//-----------------------------------------------------------------------------------------------
+// Append-only byte ring owned by one logging thread and drained by the logger thread. Messages are
+// formatted straight into the ring so logging costs no allocations, and the memory is reused once
+// the logger has written a batch out
+//
+// A record identical to the thread's previous one within LOG_REPEAT_WINDOW_MS is not committed, it
+// only bumps a repeat count that ends up as a marker record before the next different message, or
+// is picked up by the logger if the thread goes quiet
+class LogThreadBuffer
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	LogThreadBuffer( size_t capacity, uintptr_t threadId ); // Capacity must be a power of two
+	~LogThreadBuffer();
+
+	LogThreadBuffer( const LogThreadBuffer& ) = delete;
+	LogThreadBuffer& operator=( const LogThreadBuffer& ) = delete;
+	ALIGNED_NEW_AND_DELETE(LogThreadBuffer)
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			uintptr_t	GetThreadID() const { return m_threadId; }
+			bool		IsOrphaned() const { return m_isOrphaned.load(std::memory_order_acquire); }
+			void		MarkOrphaned() { m_isOrphaned.store(true, std::memory_order_release); } // Owner thread has exited
+			bool		HasPendingRecords() const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+
+	// Owner thread only
+			bool		TryAppend( uint16_t tagId, const char* tag, const char* format, va_list args ); // Returns false if full
+			bool		TryAppendBinary( uint16_t tagId, const char* format, va_list args ); // Stores the format pointer and raw args, format must outlive the flush
+			char*		ReserveRecord( size_t maxRecordSize ); // Contiguous space for one record, null if full
+			void		CommitRecord( size_t recordSize );
+			void		CommitOrCollapse( char* record, const char* payload, size_t payloadSize ); // Folds repeats into the repeat count
+			bool		GetLastRecord( LogRecord& outRecord ) const; // Record just appended, false if it was folded into a repeat
+
+	// Logger thread only
+			size_t		ReadRecords( std::vector<LogRecord>& outRecords ); // Appends everything committed
+			void		Release(); // Hands the space of the last ReadRecords back to the owner
+			uint64_t	TakeExpiredRepeats( uint64_t nowHpc, uint64_t windowHpc ); // Repeats of a thread that went quiet, packed tag, binary bit and count
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	alignas(64) std::atomic<size_t>	m_writePos{0};		// Bytes committed by the owner
+				size_t				m_reservePos = 0;	// Owner only, start of the reserved record
+				const char*			m_lastRecord = nullptr; // Owner only, null if the last append was a repeat
+				uint64_t			m_lastHash = 0;		// Owner only, identifies the last committed record
+				std::atomic<uint64_t>	m_lastHpc{0};	// Written by the owner only
+				uint64_t			m_repeatWindowHpc = 0;
+	alignas(64) std::atomic<uint64_t>	m_pendingRepeats{0}; // Repeats of the last record not turned into a marker yet
+	alignas(64) std::atomic<size_t>	m_readPos{0};		// Bytes released by the logger
+				size_t				m_pendingReadPos = 0;
+	alignas(64) char*				m_data = nullptr;
+				size_t				m_capacity = 0;
+				uintptr_t			m_threadId = 0;
+				std::atomic<bool>	m_isOrphaned{false};
+				LogThreadBuffer*	m_next = nullptr;	// Logger's list of buffers
+};
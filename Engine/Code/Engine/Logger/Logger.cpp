@@ -3,8 +3,13 @@
 // Engine Includes
 #include "Engine/Async/Thread.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/EngineConfig.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/File/File.hpp"
+#include "Engine/Logger/LogBenchmark.hpp"
+#include "Engine/Logger/LogBinaryFormat.hpp"
+#include "Engine/Logger/LogFlightRecorder.hpp"
+#include "Engine/Logger/LogRotatingFile.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Console/CommandDefinition.hpp"
 #include "Engine/Console/Command.hpp"
@@ -15,22 +20,64 @@
 
 //-----------------------------------------------------------------------------------------------
 // Standard Includes
+#include <algorithm>
+#include <deque>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define FLIGHT_RECORDER_FILE		"Log/flight.ring" // Same name every run, so the next run can dump it after a crash
+
 //-----------------------------------------------------------------------------------------------
 // Static globals
 static Logger*	s_logger = nullptr;
-static File*	s_timeStampedLog = nullptr;
+static LogRotatingFile*	s_timeStampedLog = nullptr;
 static File*	s_logFile = nullptr;
+static std::vector<FileWriteSpan>	s_flushSpans; // Only touched while holding the flush lock
+static std::atomic<uint32_t>		s_bufferGeneration{1}; // Bumped when the logger frees every thread buffer
+
+// Binary log, only touched while holding the flush lock
+static LogRotatingFile*						s_binaryLog = nullptr; // First segment is opened when the first binary record is flushed
+static std::vector<char>					s_binaryBatch;
+static bool									s_binaryDefinedTags[LOG_MAX_TAGS] = {}; // Tags that have a definition record in the file
+static std::unordered_map<const char*, uint32_t>	s_binaryFormatIds;
+static char									s_binaryText[LOG_MAX_MESSAGE_LENGTH]; // Binary records decoded for the hooks
+
+// Repeat and rate limit notices, only touched while holding the flush lock
+static const char*							s_repeatNoticeFormat = "(last message repeated %llu times)\n";
+static const char*							s_suppressedNoticeFormat = "(%llu messages suppressed by rate limit)\n";
+static std::deque<std::string>				s_noticeStorage; // Lines or encoded args of this flush's notices
+static uint64_t								s_lastSuppressedReportHpc = 0;
+
+//-----------------------------------------------------------------------------------------------
+// Marks the thread's log buffer as orphaned when the thread exits so the logger can free it
+struct LogThreadBufferRef
+{
+	~LogThreadBufferRef()
+	{
+		if(buffer != nullptr && generation == s_bufferGeneration.load(std::memory_order_acquire))
+		{
+			buffer->MarkOrphaned();
+		}
+	}
+
+	LogThreadBuffer*	buffer = nullptr;
+	uint32_t			generation = 0;
+};
+
+static thread_local LogThreadBufferRef t_logBuffer;
 
 //-----------------------------------------------------------------------------------------------
 // Starts up the logger system and timestamps the fileName
 //
 void LogSystemStartup(const char* fileName /*= DEFAULT_LOG_TAG */)
 {
+	Time::CreateInstance(); // Rotation and rate limits run on it before the clock system starts
 	Logger::CreateInstance();
-	s_logger->m_thread = ThreadCreate("Logger Thread", s_logger->LogThreadWorker, nullptr);
 
 	std::string logFileName = "Log/";
 	logFileName += fileName;
@@ -47,12 +94,19 @@ void LogSystemStartup(const char* fileName /*= DEFAULT_LOG_TAG */)
 
 	//YYYYMMDD_HHMMSS
 	std::string timeStamp = Time::GetSysTimeStamp();
-	logFileName = logFileName + "_" + timeStamp + ".txt"; // Append the time stamp onto the fileName
+	logFileName = logFileName + "_" + timeStamp; // Append the time stamp onto the fileName, segments add _NNN.txt
 
-	s_timeStampedLog = new File();
-	int errorCode = s_timeStampedLog->Open(logFileName.c_str(), FILE_WRITE);
+	s_timeStampedLog = new LogRotatingFile(logFileName, ".txt", FILE_WRITE);
+	int errorCode = s_timeStampedLog->Open() ? 0 : 1;
+
+	// Binary mode writes next to it
+	s_binaryLog = new LogRotatingFile(logFileName, ".binlog", FILE_WRITE_BINARY);
+
+#if defined( LOG_ENABLE_FLIGHT_RECORDER )
+	std::string crashDumpFileName = logFileName + "_previous_crash.txt";
+	FlightRecorderStartup(FLIGHT_RECORDER_FILE, crashDumpFileName.c_str());
+#endif
 
-	
 	if(errorCode != 0 && errorCode2 != 0) // fopen error codes
 	{
 		GUARANTEE_OR_DIE(false, "Couldn't create log file");
@@ -63,7 +117,19 @@ void LogSystemStartup(const char* fileName /*= DEFAULT_LOG_TAG */)
 		s_logFile = nullptr;
 	}
 
-	LogHook(Logger::WriteLogToFile, s_timeStampedLog);
+	// Files are set up before the logger thread starts writing to them
+	LogArchiverStartup();
+	s_logger->m_thread = ThreadCreate("Logger Thread", s_logger->LogThreadWorker, nullptr);
+
+	// Logging is not frame critical, keep it off the main thread's core and below normal priority
+	uint64_t loggerCores = ThreadGetAllCoresMask() & ~((uint64_t) 1 << ENGINE_MAIN_THREAD_CORE);
+	if(loggerCores != 0)
+	{
+		ThreadSetAffinity((ThreadHandle) s_logger->m_thread, loggerCores);
+	}
+	ThreadSetPriority((ThreadHandle) s_logger->m_thread, THREAD_PRIO_LOW);
+
+	// The timestamped log is written in batches by the logger thread, not through a hook
 	LogHook(PrintToIDE, nullptr);
 }
 
@@ -84,12 +150,199 @@ void LogSystemShutdown()
 		delete s_timeStampedLog;
 		s_timeStampedLog = nullptr;
 	}
+
+	if(s_binaryLog != nullptr)
+	{
+		s_binaryLog->Close();
+		delete s_binaryLog;
+		s_binaryLog = nullptr;
+	}
+
+	LogArchiverShutdown();
+	FlightRecorderShutdown();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends bytes to the binary batch
+//
+static void AppendBinaryBytes(const void* data, size_t size)
+{
+	const char* bytes = (const char*) data;
+	s_binaryBatch.insert(s_binaryBatch.end(), bytes, bytes + size);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends a message record to the binary batch, defining its tag and format first if this is the
+// first time the file sees them
+//
+static void AppendBinaryRecord(const LogRecord& record)
+{
+	// The file uses the interned tag IDs
+	uint16_t tagId = record.tagId;
+	if(!s_binaryDefinedTags[tagId])
+	{
+		s_binaryDefinedTags[tagId] = true;
+
+		uint8_t type = LOG_BINARY_TAG;
+		uint16_t length = (uint16_t) record.tagLength;
+		AppendBinaryBytes(&type, sizeof(type));
+		AppendBinaryBytes(&tagId, sizeof(tagId));
+		AppendBinaryBytes(&length, sizeof(length));
+		AppendBinaryBytes(record.tag, record.tagLength);
+	}
+
+	uint32_t formatId;
+	std::unordered_map<const char*, uint32_t>::iterator foundFormat = s_binaryFormatIds.find(record.format);
+	if(foundFormat == s_binaryFormatIds.end())
+	{
+		formatId = (uint32_t) s_binaryFormatIds.size();
+		s_binaryFormatIds[record.format] = formatId;
+
+		uint8_t type = LOG_BINARY_FORMAT;
+		uint32_t length = (uint32_t) strlen(record.format);
+		AppendBinaryBytes(&type, sizeof(type));
+		AppendBinaryBytes(&formatId, sizeof(formatId));
+		AppendBinaryBytes(&length, sizeof(length));
+		AppendBinaryBytes(record.format, length);
+	}
+	else
+	{
+		formatId = foundFormat->second;
+	}
+
+	uint8_t type = LOG_BINARY_MESSAGE;
+	uint32_t argsSize = (uint32_t) record.argsSize;
+	AppendBinaryBytes(&type, sizeof(type));
+	AppendBinaryBytes(&tagId, sizeof(tagId));
+	AppendBinaryBytes(&formatId, sizeof(formatId));
+	AppendBinaryBytes(&argsSize, sizeof(argsSize));
+	AppendBinaryBytes(record.args, record.argsSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the magic and version a binary log segment starts with
+//
+static void WriteBinaryHeader()
+{
+	uint32_t fileHeader[2] = { LOG_BINARY_MAGIC, LOG_BINARY_VERSION };
+	FileWriteSpan headerSpan = { fileHeader, sizeof(fileHeader) };
+	s_binaryLog->WriteGather(&headerSpan, 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the binary batch, creating the binary log with its header on first use
+//
+static void WriteBinaryBatch()
+{
+	if(s_binaryLog == nullptr)
+	{
+		return;
+	}
+
+	if(!s_binaryLog->IsOpen())
+	{
+		// After a failure RotateLogFiles does the retries, at their own pace
+		if(s_binaryLog->HasFailedOpen() || !s_binaryLog->Open())
+		{
+			return;
+		}
+
+		WriteBinaryHeader();
+	}
+
+	FileWriteSpan batchSpan = { s_binaryBatch.data(), s_binaryBatch.size() };
+	s_binaryLog->WriteGather(&batchSpan, 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts new segments once the active ones are too big or too old. Each binary segment defines its
+// own tags and formats, so it can be decoded without the ones before it
+//
+static void RotateLogFiles()
+{
+	if(s_timeStampedLog != nullptr && s_timeStampedLog->ShouldRotate())
+	{
+		s_timeStampedLog->Rotate();
+	}
+
+	if(s_binaryLog != nullptr && s_binaryLog->ShouldRotate())
+	{
+		memset(s_binaryDefinedTags, 0, sizeof(s_binaryDefinedTags));
+		s_binaryFormatIds.clear();
+
+		if(s_binaryLog->Rotate())
+		{
+			WriteBinaryHeader();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Gets everything written so far onto disk
+//
+static void FlushLogFiles()
+{
+	if(s_timeStampedLog != nullptr)
+	{
+		s_timeStampedLog->Flush();
+	}
+
+	if(s_binaryLog != nullptr)
+	{
+		s_binaryLog->Flush();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns record into a logger generated notice about its tag, either a "tag: text" line or a binary
+// record with the value as its only argument
+//
+static void MakeNoticeRecord(LogRecord& record, const LogTagRegistry& tags, bool isBinary, const char* format, uint64_t value)
+{
+	bool hasName = record.tagId < LOG_MAX_TAGS;
+	const char* tag = hasName ? tags.GetName(record.tagId) : DEFAULT_LOG_TAG;
+	size_t tagLength = hasName ? tags.GetNameLength(record.tagId) : strlen(DEFAULT_LOG_TAG);
+
+	record.repeatCount = 0;
+	record.isBinaryRepeat = false;
+
+	if(isBinary && hasName)
+	{
+		s_noticeStorage.emplace_back((const char*) &value, sizeof(value));
+
+		record.tag = tag;
+		record.tagLength = tagLength;
+		record.line = nullptr;
+		record.lineLength = 0;
+		record.format = format;
+		record.args = s_noticeStorage.back().data();
+		record.argsSize = sizeof(value);
+		return;
+	}
+
+	char text[128];
+	int textLength = snprintf(text, sizeof(text), format, (unsigned long long) value);
+
+	s_noticeStorage.emplace_back(tag, tagLength);
+	std::string& line = s_noticeStorage.back();
+	line += ": ";
+	line.append(text, textLength);
+
+	record.tag = line.data();
+	record.tagLength = tagLength;
+	record.line = line.data();
+	record.lineLength = line.size();
+	record.format = nullptr;
+	record.args = nullptr;
+	record.argsSize = 0;
 }
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
 Logger::Logger()
+	: m_flushLock("LogFlush")
+	, m_hooks("LogHooks")
 {
 	COMMAND("logflushtest", FlushTestCommand, "Tests the log flush utility");
 	COMMAND("logtest", LogTestCommand, "Threaded logger stress test");
@@ -97,6 +350,11 @@ Logger::Logger()
 	COMMAND("logdisableall", LogDisableAllCommand,"Disables all tags for logging");
 	COMMAND("logshowtag", LogEnableTagCommand, "Enables a single tag for logging");
 	COMMAND("loghidetag", LogHideTagCommand, "Hides a single tag during logging");
+	COMMAND("logmode", LogModeCommand, "Switches logging between text and binary (deferred formatting)");
+	COMMAND("logdecode", LogDecodeCommand, "Decodes a binary log into a text log: logdecode <binlog> [textfile]");
+	COMMAND("lograte", LogRateCommand, "Limits a tag to a rate: lograte <tag> <messagesPerSecond> [burst], 0 removes it, no args lists limits");
+	COMMAND("flightdump", FlightDumpCommand, "Dumps the flight recorder ring as text: flightdump [ringfile] [textfile]");
+	COMMAND("logbench", LogBenchCommand, "Benchmarks the logger: logbench [threads] [messages] [size] [tags] [hidden%] [text|binary], or logbench suite");
 	DisableTag("debug");
 
 }
@@ -107,6 +365,17 @@ Logger::Logger()
 Logger::~Logger()
 {
 	Flush();
+
+	// Threads still holding a buffer will make a new one if a logger is created again
+	s_bufferGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+	LogThreadBuffer* buffer = m_threadBuffers.exchange(nullptr);
+	while(buffer != nullptr)
+	{
+		LogThreadBuffer* next = buffer->m_next;
+		delete buffer;
+		buffer = next;
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -193,30 +462,427 @@ bool Logger::LogHideTagCommand(Command& cmd)
 	return true;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Console command to switch between text and binary logging
+//
+bool Logger::LogModeCommand(Command& cmd)
+{
+	std::string mode = cmd.GetNextString();
+
+	if(mode == "text")
+	{
+		LogSetMode(LOG_MODE_TEXT);
+	}
+	else if(mode == "binary")
+	{
+		LogSetMode(LOG_MODE_BINARY);
+		ConsolePrintf("Binary log: %s_NNN.binlog", s_binaryLog != nullptr ? s_binaryLog->m_basePath.c_str() : "");
+	}
+	else
+	{
+		ConsolePrintf(Rgba::RED, "Usage: logmode text|binary");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to decode a binary log into a text log
+//
+bool Logger::LogDecodeCommand(Command& cmd)
+{
+	std::string binaryFileName = cmd.GetNextString();
+	std::string textFileName = cmd.GetNextString();
+
+	if(binaryFileName.empty())
+	{
+		ConsolePrintf(Rgba::RED, "Usage: logdecode <binlog> [textfile]");
+		return false;
+	}
+
+	if(textFileName.empty())
+	{
+		textFileName = binaryFileName + ".txt";
+	}
+
+	// The log being written may still have records in flight
+	LogFlush();
+
+	if(!LogDecodeBinaryFile(binaryFileName.c_str(), textFileName.c_str()))
+	{
+		ConsolePrintf(Rgba::RED, "Couldn't decode %s", binaryFileName.c_str());
+		return false;
+	}
+
+	ConsolePrintf("Decoded %s into %s", binaryFileName.c_str(), textFileName.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to rate limit a tag, or to list the limits and what they dropped
+//
+bool Logger::LogRateCommand(Command& cmd)
+{
+	LogRateLimiter& rateLimiter = s_logger->m_rateLimiter;
+	LogTagRegistry& tags = s_logger->m_tags;
+
+	std::string tag = cmd.GetNextString();
+	if(tag.empty())
+	{
+		uint32_t tagCount = tags.m_count.load(std::memory_order_acquire);
+		for(uint32_t tagId = 0; tagId < tagCount; ++tagId)
+		{
+			if(rateLimiter.HasLimit((uint16_t) tagId) || rateLimiter.GetSuppressedTotal((uint16_t) tagId) != 0)
+			{
+				ConsolePrintf("%s: %d/s burst %d, %llu suppressed", tags.GetName((uint16_t) tagId), rateLimiter.GetMessagesPerSecond((uint16_t) tagId),
+					rateLimiter.GetBurst((uint16_t) tagId), (unsigned long long) rateLimiter.GetSuppressedTotal((uint16_t) tagId));
+			}
+		}
+
+		return true;
+	}
+
+	int messagesPerSecond = 0;
+	if(!cmd.GetNextInt(messagesPerSecond))
+	{
+		ConsolePrintf(Rgba::RED, "Usage: lograte <tag> <messagesPerSecond> [burst]");
+		return false;
+	}
+
+	int burst = messagesPerSecond; // One second's worth unless told otherwise
+	cmd.GetNextInt(burst);
+
+	uint16_t tagId = tags.Intern(tag.c_str());
+	if(tagId == LOG_INVALID_TAG_ID)
+	{
+		ConsolePrintf(Rgba::RED, "Too many log tags to rate limit %s", tag.c_str());
+		return false;
+	}
+
+	rateLimiter.SetLimit(tagId, messagesPerSecond, burst);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to write the flight recorder ring out as text
+//
+bool Logger::FlightDumpCommand(Command& cmd)
+{
+	std::string ringFileName = cmd.GetNextString();
+	std::string textFileName = cmd.GetNextString();
+
+	if(ringFileName.empty())
+	{
+		ringFileName = FLIGHT_RECORDER_FILE;
+	}
+
+	if(textFileName.empty())
+	{
+		textFileName = ringFileName + ".txt";
+	}
+
+	if(!FlightRecorderDump(ringFileName.c_str(), textFileName.c_str()))
+	{
+		ConsolePrintf(Rgba::RED, "Couldn't dump flight recorder %s", ringFileName.c_str());
+		return false;
+	}
+
+	ConsolePrintf("Flight recorder dumped to %s", textFileName.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to benchmark the logger. Results are appended to Log/logbench.jsonl
+//
+bool Logger::LogBenchCommand(Command& cmd)
+{
+	std::vector<LogBenchmarkResult> results;
+	std::string firstArg = cmd.GetNextString();
+
+	if(firstArg == "suite")
+	{
+		LogRunBenchmarkSuite(results);
+	}
+	else
+	{
+		LogBenchmarkConfig config;
+		if(!firstArg.empty())
+		{
+			config.threadCount = atoi(firstArg.c_str());
+		}
+		cmd.GetNextInt(config.messagesPerThread);
+		cmd.GetNextInt(config.messageSize);
+		cmd.GetNextInt(config.tagCount);
+		cmd.GetNextInt(config.hiddenTagPercent);
+
+		if(cmd.GetNextString() == "binary")
+		{
+			config.mode = LOG_MODE_BINARY;
+		}
+
+		results.push_back(LogRunBenchmark(config));
+	}
+
+	std::string lines;
+	for(const LogBenchmarkResult& result : results)
+	{
+		const LogBenchmarkConfig& config = result.config;
+		ConsolePrintf("%d threads, %d chars, %d%% hidden, %s: %.0f msgs/s, enqueue p50 %.2fus p99 %.2fus p999 %.2fus, disk p50 %.2fms p99 %.2fms, drain %.2fms",
+			config.threadCount, config.messageSize, config.hiddenTagPercent, config.mode == LOG_MODE_BINARY ? "binary" : "text",
+			result.messagesPerSecond, result.enqueueP50Us, result.enqueueP99Us, result.enqueueP999Us, result.diskP50Ms, result.diskP99Ms, result.drainMs);
+
+		lines += LogBenchmarkToJson(result) + "\n";
+	}
+
+	FileAppendToFile("Log/logbench.jsonl", lines.c_str(), lines.size());
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Will ensure that before returning, all currently in flight log messages are complete, 
 // and the file IO operations have been flushed
 //
 void Logger::Flush()
 {
-	LogMessage* msg;
-	while(m_logQueue.Dequeue(&msg))
+	m_flushLock.Enter();
+
+	// Anything logged before these requests was committed before they were made, so it gets read below
+	uint64_t flushRequests = m_flushRequests.load(std::memory_order_acquire);
+
+	// Hooks can change while we run, work off one snapshot for the batch
+	const std::vector<LogHookDef*>& hooks = *m_hooks.GetSnapshot();
+
+	m_flushRecords.clear();
+	s_flushSpans.clear();
+	s_binaryBatch.clear();
+	s_noticeStorage.clear();
+
+	// Before the batch is built, since it may define tags and formats for the new segment
+	RotateLogFiles();
+
+	uint64_t nowHpc = Time::GetPerformanceCounter();
+	uint64_t repeatWindowHpc = Time::SecondsToHpc(LOG_REPEAT_WINDOW_MS / 1000.f);
+
+	LogThreadBuffer* firstBuffer = m_threadBuffers.load(std::memory_order_acquire);
+	for(LogThreadBuffer* buffer = firstBuffer; buffer != nullptr; buffer = buffer->m_next)
+	{
+		buffer->ReadRecords(m_flushRecords);
+
+		// Repeats of a thread that has gone quiet, reported after its last record
+		uint64_t repeats = buffer->TakeExpiredRepeats(nowHpc, repeatWindowHpc);
+		if(repeats != 0)
+		{
+			LogRecord record = {};
+			record.tagId = (uint16_t) (repeats >> LOG_REPEAT_TAG_SHIFT);
+			record.repeatCount = repeats & LOG_REPEAT_COUNT_MASK;
+			record.isBinaryRepeat = (repeats & LOG_REPEAT_BINARY_BIT) != 0;
+			m_flushRecords.push_back(record);
+		}
+	}
+
+	// Rate limited tags say how much they dropped, at most once per report interval
+	if(nowHpc - s_lastSuppressedReportHpc >= Time::SecondsToHpc(LOG_SUPPRESSED_REPORT_MS / 1000.f))
+	{
+		s_lastSuppressedReportHpc = nowHpc;
+
+		uint32_t tagCount = m_tags.m_count.load(std::memory_order_acquire);
+		for(uint32_t tagId = 0; tagId < tagCount; ++tagId)
+		{
+			uint64_t suppressedCount = m_rateLimiter.TakeSuppressed((uint16_t) tagId);
+			if(suppressedCount != 0)
+			{
+				LogRecord record = {};
+				record.tagId = (uint16_t) tagId;
+				MakeNoticeRecord(record, m_tags, GetMode() == LOG_MODE_BINARY, s_suppressedNoticeFormat, suppressedCount);
+				m_flushRecords.push_back(record);
+			}
+		}
+	}
+
+	for(LogRecord& record : m_flushRecords)
+	{
+		// Checked again in case the tag was hidden after the message was logged
+		if(!m_tags.IsEnabled(record.tagId))
+		{
+			continue;
+		}
+
+		if(record.repeatCount != 0)
+		{
+			MakeNoticeRecord(record, m_tags, record.isBinaryRepeat, s_repeatNoticeFormat, record.repeatCount);
+		}
+
+		if(record.format != nullptr)
+		{
+			record.tag = m_tags.GetName(record.tagId);
+			record.tagLength = m_tags.GetNameLength(record.tagId);
+			AppendBinaryRecord(record);
+		}
+		else
+		{
+			s_flushSpans.push_back({ record.line, record.lineLength });
+		}
+
+		if(!hooks.empty())
+		{
+			m_hookMessage.tag.assign(record.tag, record.tagLength);
+
+			if(record.format != nullptr)
+			{
+				size_t textLength = LogBinaryFormatMessage(s_binaryText, LOG_MAX_MESSAGE_LENGTH, record.format, record.args, record.argsSize);
+				m_hookMessage.text.assign(s_binaryText, textLength);
+			}
+			else
+			{
+				size_t textOffset = record.tagLength + 2;
+				m_hookMessage.text.assign(record.line + textOffset, record.lineLength - textOffset);
+			}
+
+			for(LogHookDef* hook : hooks)
+			{
+				hook->callback(m_hookMessage, hook->userData);
+			}
+		}
+	}
+
+	// One gathered write for the whole batch
+	if(!s_flushSpans.empty() && s_timeStampedLog != nullptr)
+	{
+		s_timeStampedLog->WriteGather(s_flushSpans.data(), s_flushSpans.size());
+	}
+
+	if(!s_binaryBatch.empty())
+	{
+		WriteBinaryBatch();
+	}
+
+	// Written out, hand the space back and free the buffers of threads that have exited. The first
+	// buffer is left alone since new buffers are being linked in front of it
+	LogThreadBuffer* prevBuffer = nullptr;
+	LogThreadBuffer* buffer = firstBuffer;
+	while(buffer != nullptr)
 	{
-		if((m_filters.Find(msg->tag) != UINT32_MAX) ^ m_areFiltersWhiteList)
+		LogThreadBuffer* nextBuffer = buffer->m_next;
+		buffer->Release();
+
+		if(prevBuffer != nullptr && buffer->IsOrphaned() && !buffer->HasPendingRecords())
 		{
-			delete msg; // Cleanup
-			continue; // Filter found 
+			prevBuffer->m_next = nextBuffer;
+			delete buffer;
+		}
+		else
+		{
+			prevBuffer = buffer;
 		}
 
-		for(size_t index = 0; index < m_hooks.Size(); ++index)
+		buffer = nextBuffer;
+	}
+
+	if(flushRequests > m_flushesCompleted.load(std::memory_order_relaxed))
+	{
+		FlushLogFiles();
+
+		m_flushesCompleted.store(flushRequests, std::memory_order_release);
+		m_flushDoneSignal.Notify();
+	}
+
+	// Flushes are serialized, so nobody can still be reading a replaced snapshot
+	m_hooks.Reclaim();
+
+	m_flushLock.Leave();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Flushes the log files under the flush lock, so a Flush on another thread can't be rotating them
+//
+void Logger::FlushFiles()
+{
+	m_flushLock.Enter();
+	FlushLogFiles();
+	m_flushLock.Leave();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Requests a flush of every message logged so far and blocks until the logger thread has written
+// them out. Drains inline if there is no logger thread to wait on
+//
+void Logger::FlushAndWait()
+{
+	if(m_thread == nullptr || !IsRunning() || ThreadGetCurrentID() == m_threadId.load(std::memory_order_relaxed))
+	{
+		Flush();
+		FlushFiles();
+		return;
+	}
+
+	uint64_t ticket = m_flushRequests.fetch_add(1) + 1;
+	m_workSignal.Notify();
+
+	while(m_flushesCompleted.load(std::memory_order_acquire) < ticket)
+	{
+		uint64_t epoch = m_flushDoneSignal.PrepareWait();
+
+		if(m_flushesCompleted.load(std::memory_order_acquire) >= ticket)
 		{
-			m_hooks[index]->callback(*msg, m_hooks[index]->userData);
+			m_flushDoneSignal.CancelWait();
+			break;
 		}
 
-		delete msg; // Cleanup
+		// Timeout only guards against the logger thread stopping under us
+		m_flushDoneSignal.Wait(epoch, LOG_FLUSH_INTERVAL_MS);
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if any thread has logged something that has not been written yet
+//
+bool Logger::HasPendingMessages()
+{
+	m_flushLock.Enter();
+
+	bool hasPending = false;
+	for(LogThreadBuffer* buffer = m_threadBuffers.load(std::memory_order_acquire); buffer != nullptr && !hasPending; buffer = buffer->m_next)
+	{
+		hasPending = buffer->HasPendingRecords();
+	}
+
+	m_flushLock.Leave();
+	return hasPending;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the calling thread's log buffer, creating and registering it the first time
+//
+LogThreadBuffer* Logger::GetThreadBuffer()
+{
+	uint32_t generation = s_bufferGeneration.load(std::memory_order_acquire);
+
+	if(t_logBuffer.buffer == nullptr || t_logBuffer.generation != generation)
+	{
+		LogThreadBuffer* buffer = new LogThreadBuffer(LOG_THREAD_BUFFER_SIZE, ThreadGetCurrentID());
+
+		buffer->m_next = m_threadBuffers.load(std::memory_order_relaxed);
+		while(!m_threadBuffers.compare_exchange_weak(buffer->m_next, buffer, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+
+		t_logBuffer.buffer = buffer;
+		t_logBuffer.generation = generation;
+	}
+
+	return t_logBuffer.buffer;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stops the logger thread, it drains the queue once more before exiting
+//
+void Logger::Stop()
+{
+	m_isRunning.store(false, std::memory_order_release);
+	m_workSignal.Notify();
+}
+
 //-----------------------------------------------------------------------------------------------
 // Adds a hook to the list of hooks 
 //
@@ -250,82 +916,147 @@ void Logger::RemoveHook(LogHookDef* hook)
 //
 void Logger::RemoveHook(LogCb cb, void* userData)
 {
-	for(size_t index = 0; index < m_hooks.Size(); ++index)
+	m_hooks.Modify([cb, userData](std::vector<LogHookDef*>& hooks)
 	{
-		if(m_hooks[index]->callback == cb && m_hooks[index]->userData == userData)
+		for(size_t index = 0; index < hooks.size(); ++index)
 		{
-			m_hooks.Erase(index);
-			break;
+			if(hooks[index]->callback == cb && hooks[index]->userData == userData)
+			{
+				hooks.erase(hooks.begin() + index);
+				break;
+			}
 		}
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------------------------
-// Adds a log message to the queue
+// Adds a log message to the calling thread's buffer
 //
 void Logger::AddLogMessage(const std::string& tag, const std::string& text)
 {
-	LogMessage* msg = new LogMessage();
-	msg->tag = tag;
-	msg->text = text;
-
-	AddLogMessage(msg);
+	AppendMessagef(tag.c_str(), "%s", text.c_str());
 }
 
 //-----------------------------------------------------------------------------------------------
-// Adds a log message to the queue
+// Adds a log message to the calling thread's buffer and frees it
 //
 void Logger::AddLogMessage(LogMessage* msg)
 {
-	m_logQueue.Enqueue(msg);
+	AddLogMessage(msg->tag, msg->text);
+	delete msg;
 }
 
 //-----------------------------------------------------------------------------------------------
-// If blacklist, tag is removed. If whitelist, tag is added
+// Formats a message into the calling thread's buffer. Waits for the logger thread if it is full
 //
-void Logger::EnableTag(const char* tag)
+void Logger::AppendMessagev(const char* tag, const char* format, va_list args)
 {
-	if(m_areFiltersWhiteList == false)
+	uint16_t tagId = m_tags.Intern(tag);
+	if(!m_tags.IsEnabled(tagId))
 	{
-		m_filters.Erase(tag);
+		return; // Rejected before anything is formatted or allocated
 	}
-	else
+
+	if(m_rateLimiter.HasLimit(tagId) && !m_rateLimiter.TryAcquire(tagId))
 	{
-		m_filters.PushBack(tag);
+		return; // Counted, the logger reports how many were dropped
 	}
+
+	// Binary records find their tag by ID, which a full registry can't hand out
+	bool isBinary = GetMode() == LOG_MODE_BINARY && tagId != LOG_INVALID_TAG_ID;
+	LogThreadBuffer* buffer = GetThreadBuffer();
+
+	while(true)
+	{
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		bool wasAppended = isBinary ? buffer->TryAppendBinary(tagId, format, argsCopy) : buffer->TryAppend(tagId, tag, format, argsCopy);
+		va_end(argsCopy);
+
+		if(wasAppended)
+		{
+			break;
+		}
+
+		if(buffer->GetThreadID() == m_threadId.load(std::memory_order_relaxed))
+		{
+			// Logged from a hook, waiting for ourselves to flush would never end
+			m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		if(IsRunning())
+		{
+			m_workSignal.Notify();
+			ThreadYield();
+		}
+		else
+		{
+			Flush();
+		}
+	}
+
+#if defined( LOG_ENABLE_FLIGHT_RECORDER )
+	// Copied from the thread's buffer, repeats are left out
+	LogRecord record;
+	if(FlightRecorderIsRunning() && buffer->GetLastRecord(record))
+	{
+		if(record.format != nullptr)
+		{
+			FlightRecorderWrite(FLIGHT_ENTRY_FORMAT, m_tags.GetName(tagId), m_tags.GetNameLength(tagId), record.format, strlen(record.format));
+		}
+		else
+		{
+			size_t textOffset = record.tagLength + 2;
+			FlightRecorderWrite(FLIGHT_ENTRY_MESSAGE, record.line, record.tagLength, record.line + textOffset, record.lineLength - textOffset);
+		}
+	}
+#endif
+
+	m_workSignal.Notify(); // Just a load unless the logger thread is asleep
+}
+
+//-----------------------------------------------------------------------------------------------
+// Formats a message into the calling thread's buffer
+//
+void Logger::AppendMessagef(const char* tag, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	AppendMessagev(tag, format, args);
+	va_end(args);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the tag's enabled bit
+//
+void Logger::EnableTag(const char* tag)
+{
+	m_tags.SetEnabled(m_tags.Intern(tag), true);
 }
 
 //-----------------------------------------------------------------------------------------------
-// If whitelist, tag is added. If blacklist, tag is removed
+// Clears the tag's enabled bit
 //
 void Logger::DisableTag(const char* tag)
 {
-	if(m_areFiltersWhiteList)
-	{
-		m_filters.Erase(tag);
-	}
-	else
-	{
-		m_filters.PushBack(tag);
-	}
+	m_tags.SetEnabled(m_tags.Intern(tag), false);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Switches the filters to blacklist
+// Enables every tag, new tags start enabled
 //
 void Logger::EnableAll()
 {
-	m_filters.Clear();
-	m_areFiltersWhiteList = false;
+	m_tags.SetAllEnabled(true);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Switches the filters to whitelist
+// Disables every tag, new tags start disabled until shown
 //
 void Logger::DisableAll()
 {
-	m_filters.Clear();
-	m_areFiltersWhiteList = true;
+	m_tags.SetAllEnabled(false);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -384,10 +1115,25 @@ void Logger::DestroyInstance()
 void Logger::LogThreadWorker(void* userData /*= nullptr */)
 {
 	Logger* logger = Logger::GetInstance();
+	logger->m_threadId.store(ThreadGetCurrentID(), std::memory_order_relaxed);
+
 	while(logger->IsRunning())
 	{
+		// Sleep until something is logged, a flush is requested or the flush interval passes
+		uint64_t epoch = logger->m_workSignal.PrepareWait();
+
+		bool hasFlushRequest = logger->m_flushRequests.load() != logger->m_flushesCompleted.load();
+
+		if(hasFlushRequest || logger->HasPendingMessages() || !logger->IsRunning())
+		{
+			logger->m_workSignal.CancelWait();
+		}
+		else if(!logger->m_workSignal.Wait(epoch, LOG_FLUSH_INTERVAL_MS))
+		{
+			logger->FlushFiles(); // Idle, so get what was written onto disk
+		}
+
 		logger->Flush();
-		ThreadSleep(10);
 	}
 
 	logger->Flush();
@@ -428,13 +1174,7 @@ void Logger::LogTestWorker(void* userData /*= nullptr */)
 //
 void LogTaggedPrintv(const char* tag, const char* format, va_list args)
 {
-	const int MAX_LENGTH = 2048;
-	char buffer[MAX_LENGTH];
-
-	vsnprintf_s(buffer, MAX_LENGTH, _TRUNCATE, format, args);
-	buffer[MAX_LENGTH - 1] = '\0';
-
-	s_logger->AddLogMessage(tag, buffer);
+	s_logger->AppendMessagev(tag, format, args);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -442,7 +1182,15 @@ void LogTaggedPrintv(const char* tag, const char* format, va_list args)
 //
 void LogFlush()
 {
-	s_logger->Flush();
+	s_logger->FlushAndWait();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches between formatting on the calling thread and deferring it to the decoder
+//
+void LogSetMode(LogMode mode)
+{
+	s_logger->SetMode(mode);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -485,12 +1233,30 @@ void LogErrorf(const char* format, ...)
 {
 	va_list args;
 	va_start(args, format);
+	va_list markArgs;
+	va_copy(markArgs, args);
 	LogTaggedPrintv(DEFAULT_ERROR_TAG, format, args);
 	va_end(args);
+
+	if(FlightRecorderIsRunning())
+	{
+		char errorText[LOG_FLIGHT_RECORDER_SLOT_SIZE];
+		vsnprintf(errorText, sizeof(errorText), format, markArgs);
+		FlightRecorderMarkError(errorText, false);
+	}
+	va_end(markArgs);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if messages with this tag are currently logged
+//
+bool LogIsTagEnabled(const char* tag)
+{
+	return s_logger != nullptr && s_logger->IsTagEnabled(tag);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Converts the filters to blacklists
+// Enables every tag
 //
 void LogShowAll()
 {
@@ -498,7 +1264,7 @@ void LogShowAll()
 }
 
 //-----------------------------------------------------------------------------------------------
-// Converts the filters to whitelists
+// Disables every tag
 //
 void LogHideAll()
 {
@@ -506,7 +1272,7 @@ void LogHideAll()
 }
 
 //-----------------------------------------------------------------------------------------------
-// if blacklist, tag will be removed. If whitelist, tag will be added
+// Enables a single tag
 //
 void LogShowTag(const char* tag)
 {
@@ -514,7 +1280,7 @@ void LogShowTag(const char* tag)
 }
 
 //-----------------------------------------------------------------------------------------------
-// if whitelist, tag will be removed. If blacklist, tag will be added
+// Hides a single tag
 //
 void LogHideTag(const char* tag)
 {
@@ -1,7 +1,12 @@
 #pragma once
-#include "Engine/Async/ThreadSafeQueue.hpp"
 #include <string>
-#include "Engine/Async/ThreadSafeVector.hpp"
+#include "Engine/Async/SnapshotVector.hpp"
+#include "Engine/Async/Spinlock.hpp"
+#include "Engine/Async/Signal.hpp"
+#include "Engine/Enumerations/LogMode.hpp"
+#include "Engine/Logger/LogRateLimiter.hpp"
+#include "Engine/Logger/LogTagRegistry.hpp"
+#include "Engine/Logger/LogThreadBuffer.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -37,22 +42,32 @@ public:
 	// Constructors/Destructors
 	Logger();
 	~Logger();
+	ALIGNED_NEW_AND_DELETE(Logger) // Holds cache line aligned locks
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-			bool IsRunning() const { return m_isRunning; }
+			bool IsRunning() const { return m_isRunning.load(std::memory_order_acquire); }
+			LogMode GetMode() const { return m_mode.load(std::memory_order_relaxed); }
+			void SetMode( LogMode mode ) { m_mode.store(mode, std::memory_order_relaxed); } // Messages already logged keep their format
+			bool HasPendingMessages();
+			LogThreadBuffer* GetThreadBuffer(); // Creates the calling thread's buffer on first use
+			bool IsTagEnabled( const char* tag ) { return m_tags.IsEnabled(m_tags.Intern(tag)); }
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 			void Start() { m_isRunning = true; }
-			void Stop() { m_isRunning = false; }
+			void Stop();
 			void Flush();
+			void FlushFiles(); // Gets what was written onto disk, serialized with Flush since it may rotate the files
+			void FlushAndWait();
 			void AddHook( LogHookDef* hook );
 			void AddHook( LogCb cb, void* userData );
 			void RemoveHook( LogHookDef* hook );
 			void RemoveHook( LogCb cb, void* userData );
 			void AddLogMessage( LogMessage* msg );
 			void AddLogMessage( const std::string& tag, const std::string& text );
+			void AppendMessagev( const char* tag, const char* format, va_list args );
+			void AppendMessagef( const char* tag, const char* format, ... );
 			void EnableTag( const char* tag );
 			void DisableTag( const char* tag );
 			void EnableAll();
@@ -79,15 +94,30 @@ public:
 	static	bool	LogDisableAllCommand( Command& cmd );
 	static	bool	LogEnableTagCommand( Command& cmd );
 	static	bool	LogHideTagCommand( Command& cmd );
+	static	bool	LogModeCommand( Command& cmd );
+	static	bool	LogDecodeCommand( Command& cmd );
+	static	bool	LogRateCommand( Command& cmd );
+	static	bool	FlightDumpCommand( Command& cmd );
+	static	bool	LogBenchCommand( Command& cmd );
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	bool							m_isRunning = true;
-	void*							m_thread;
-	ThreadSafeQueue<LogMessage*>	m_logQueue;
-	ThreadSafeVector<LogHookDef*>	m_hooks;
-	ThreadSafeVector<std::string>	m_filters;
-	bool							m_areFiltersWhiteList = false;
+	std::atomic<bool>				m_isRunning{true};
+	std::atomic<LogMode>			m_mode{LOG_MODE_TEXT};
+	void*							m_thread = nullptr;
+	std::atomic<uintptr_t>			m_threadId{0}; // Set by the logger thread once it starts
+	std::atomic<LogThreadBuffer*>	m_threadBuffers{nullptr}; // One per thread that has logged, newest first
+	std::vector<LogRecord>			m_flushRecords; // Only touched while holding m_flushLock
+	LogMessage						m_hookMessage; // Reused for every hook call
+	Spinlock						m_flushLock; // Keeps the buffers single consumer, LogFlush can drain from any thread
+	Signal							m_workSignal; // Wakes the logger thread when messages are logged
+	Signal							m_flushDoneSignal; // Wakes LogFlush callers when their request is written
+	std::atomic<uint64_t>			m_flushRequests{0};
+	std::atomic<uint64_t>			m_flushesCompleted{0};
+	std::atomic<uint64_t>			m_droppedMessages{0}; // Logged from a hook while the logger thread's own buffer was full
+	SnapshotVector<LogHookDef*>		m_hooks; // Read lock free by the logger thread, reclaimed after each flush
+	LogTagRegistry					m_tags; // Interned tags and their enabled bits, checked before anything is formatted
+	LogRateLimiter					m_rateLimiter; // Per tag limits, checked right after the enabled bit
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -100,6 +130,7 @@ void LogSystemShutdown();
 // Logger functions
 void LogTaggedPrintv( const char* tag, const char* format, va_list args );
 void LogFlush();
+void LogSetMode( LogMode mode ); // Binary mode defers formatting, format strings must be literals or otherwise outlive the flush
 
 // Logger Helpers
 void LogTaggedPrintf( const char* tag, const char* format, ... );
@@ -108,6 +139,7 @@ void LogWarningf( const char* format, ... ); // Defaults to warning tag
 void LogErrorf( const char* format, ... ); // Defaults to error tag. Flush and then assert at the end
 
 // Filtering functions
+bool LogIsTagEnabled( const char* tag ); // Lets callers skip building messages nobody will see
 void LogShowAll();
 void LogHideAll();
 void LogShowTag( const char* tag );
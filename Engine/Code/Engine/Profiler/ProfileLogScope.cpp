@@ -8,7 +8,15 @@
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
-ProfileLogScope::ProfileLogScope(char tag[])
+ProfileLogScope::ProfileLogScope(const ProfilerScopeDesc* scope)
+{
+	Profiler::Push(scope);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfileLogScope::ProfileLogScope(const char tag[])
 {
 	Profiler::Push(tag);
 }
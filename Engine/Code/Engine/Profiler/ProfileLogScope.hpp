@@ -2,6 +2,7 @@
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
+struct ProfilerScopeDesc;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -10,7 +11,8 @@ class ProfileLogScope // Scoped class
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
-	ProfileLogScope( char tag[] );
+	ProfileLogScope( const ProfilerScopeDesc* scope );
+	ProfileLogScope( const char tag[] ); // For names only known at runtime
 	~ProfileLogScope();
 	
 	//-----------------------------------------------------------------------------------------------
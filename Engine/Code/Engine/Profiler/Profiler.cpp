@@ -6,7 +6,12 @@
 #include "Engine/Core/EngineConfig.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Profiler/ProfilerFrameArena.hpp"
+#include "Engine/Profiler/ProfilerHitch.hpp"
+#include "Engine/Profiler/ProfilerHistoryReport.hpp"
 #include "Engine/Profiler/ProfilerReport.hpp"
+#include "Engine/Profiler/ProfilerThread.hpp"
+#include "Engine/Profiler/ProfilerTraceWriter.hpp"
 #include "Engine/Console/Command.hpp"
 #include "Engine/Console/DevConsole.hpp"
 #include "Engine/UI/Canvas.hpp"
@@ -14,255 +19,1283 @@
 #include "Engine/UI/Widgets/Widget_AreaGraph.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Input/InputSystem.hpp"
+#include "Engine/Async/Spinlock.hpp"
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Profiler/ProfilerClock.hpp"
+#include "Engine/Profiler/ProfilerAllocations.hpp"
+#include "Engine/Profiler/ProfilerCounters.hpp"
+#include "Engine/Profiler/ProfilerCallTree.hpp"
+#include "Engine/Profiler/ProfilerSampler.hpp"
+#include "Engine/Logger/LogFlightRecorder.hpp"
+#include "Engine/File/File.hpp"
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <string.h>
+#include <unordered_map>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define PROFILER_TRACE_FILE			"Log/profiler_trace.json"
+#define PROFILER_STATS_FILE			"Log/profiler_stats.csv"
+#define PROFILER_HITCH_FILE			"Log/profiler_hitch_%llu.txt" // By the number of the first slow frame
+
+static_assert(PROFILER_HITCH_CONTEXT_FRAMES < PROFILER_HISTORY_SIZE, "Frames before a hitch come from the history");
+
 //-----------------------------------------------------------------------------------------------
 // Static globals
 static Profiler* g_profiler = nullptr;
 
 #if defined(ENGINE_ENABLE_PROFILING)
+static Spinlock								s_threadsLock("Profiler Threads"); // Registration of new threads
+static std::unordered_map<std::string, int>	s_threadNameCounts; // Threads registered per name, only touched while holding the lock
+static std::atomic<uint32_t>				s_threadGeneration{1}; // Bumped when the profiler frees every thread
+static const ProfilerScopeDesc*				s_frameScope = nullptr; // Main thread's root of every frame
+
+//-----------------------------------------------------------------------------------------------
+// Marks the thread's profiler events as orphaned when the thread exits so the profiler can free them
+struct ProfilerThreadRef
+{
+	~ProfilerThreadRef()
+	{
+		if(thread != nullptr && generation == s_threadGeneration.load(std::memory_order_acquire))
+		{
+			thread->MarkOrphaned();
+		}
+	}
+
+	ProfilerThread*	thread = nullptr;
+	uint32_t		generation = 0;
+};
+
+static thread_local ProfilerThreadRef t_profilerThread;
+
+//-----------------------------------------------------------------------------------------------
+// Returns the root of the given thread in a frame, the main thread's root heads the list
+//
+static ProfilerSample* FindThreadRoot(ProfilerSample* mainRoot, const char* threadName)
+{
+	if(mainRoot == nullptr || threadName == nullptr || threadName[0] == '\0')
+	{
+		return mainRoot;
+	}
+
+	for(ProfilerSample* root = mainRoot->nextSibling; root != nullptr; root = root->nextSibling)
+	{
+		if(strcmp(root->GetName(), threadName) == 0)
+		{
+			return root;
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a report of the frame in the given view and sort mode
+//
+static ProfilerReport* CreateReport(ProfilerSample* root, ReportType type, ReportSortMode sortMode)
+{
+	ProfilerReport* report = new ProfilerReport();
+
+	switch (type)
+	{
+	case REPORT_TYPE_FLAT:
+		report->GenerateFlatFromFrame(root);
+		break;
+	case REPORT_TYPE_TREE:
+		report->GenerateTreeFromFrame(root);
+		break;
+	default:
+		GUARANTEE_OR_DIE(false, "Wrong report frame type");
+		break;
+	}
+
+	switch (sortMode)
+	{
+	case SORT_BY_NONE:			/* DO NOTHING */ 				break;
+	case SORT_BY_TOTAL_TIME:	report->SortByTotalTime();		break;
+	case SORT_BY_SELF_TIME:		report->SortBySelfTime(); 		break;
+	default:
+		GUARANTEE_OR_DIE(false, "Bad report sort mode");
+		break;
+	}
+
+	return report;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Resolves a console command's thread argument: nothing, "all", a thread index or a thread name.
+// Thread names have spaces, so the rest of the line is the argument. Leaves outThreadNames empty
+// when there is none, returns false if the index is out of range
+//
+static bool ResolveThreadArgument(Command& cmd, std::vector<std::string>* outThreadNames)
+{
+	std::string threadStr = cmd.GetNextString();
+	for(std::string nextToken = cmd.GetNextString(); nextToken != ""; nextToken = cmd.GetNextString())
+	{
+		threadStr += " " + nextToken;
+	}
+
+	std::vector<std::string> threadNames = g_profiler->GetThreadNames();
+	if(threadStr == "")
+	{
+		outThreadNames->clear();
+	}
+	else if(threadStr == "all")
+	{
+		*outThreadNames = threadNames;
+	}
+	else if(threadStr.find_first_not_of("0123456789") == std::string::npos)
+	{
+		size_t threadIndex = (size_t) atoi(threadStr.c_str());
+		if(threadIndex >= threadNames.size())
+		{
+			ConsolePrintf("No thread %u, there are %u", (unsigned int) threadIndex, (unsigned int) threadNames.size());
+			return false;
+		}
+
+		*outThreadNames = { threadNames[threadIndex] };
+	}
+	else
+	{
+		*outThreadNames = { threadStr };
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
 Profiler::Profiler()
 {
+	ProfilerClockStartup(); // Before any timestamp is taken
+
 	m_prevStacks.resize(PROFILER_HISTORY_SIZE);
-	
-	m_canvas = new Canvas();
-	m_reportBoxRef = m_canvas->AddTextBox("reportBox", Vector2::ZERO, Vector2(1.f, 0.7f), "test");
-	m_controlsBoxRef = m_canvas->AddTextBox("controlsBox", Vector2(0.f, 0.72f), Vector2(0.4f, 0.82f), "controlsBox");
-	m_statusBoxRef = m_canvas->AddTextBox("statusBox", Vector2(0.f, 0.84f), Vector2(0.4f, 0.94f), "statusBox");
-	
-	m_graphBoxRef = m_canvas->AddAreaGraph("usageGraph", Vector2(0.5f, 0.72f), Vector2(1.f, 0.94f), {});
-	m_graphBoxRef->SetOnClick(CPUGraphClickListener);
-	m_graphBoxRef->SetThresholds(18.f, 22.f); // FPS: 55, 45
+
+	m_activeArena = new ProfilerFrameArena();
+	m_sampledArena = new ProfilerFrameArena();
+	for(int frameIndex = 0; frameIndex < PROFILER_HISTORY_SIZE; ++frameIndex)
+	{
+		m_prevArenas.push_back(new ProfilerFrameArena());
+	}
+
+	// Created on the main thread, the frame is timed by its MarkFrame calls
+	s_frameScope = ProfilerRegisterScope(PROFILER_START_FRAME_TEXT, __FILE__, __LINE__);
+	m_mainThread = RegisterThread(PROFILER_MAIN_THREAD_NAME);
+	t_profilerThread.thread = m_mainThread;
+	t_profilerThread.generation = s_threadGeneration.load(std::memory_order_acquire);
+
 
 	COMMAND("profiler_pause", PauseProfilerCommand, "Pauses the profiler if running");
 	COMMAND("profiler_resume", ResumeProfilerCommand, "Resumes the profiler if paused");
 	COMMAND("profiler", ProfilerCommand, "Shows the profiler view");
-	COMMAND("profiler_report", ProfilerReportCommand, "Prints last frame report to console (tree|flat)");
+	COMMAND("profiler_report", ProfilerReportCommand, "Prints last frame report to console: profiler_report [tree|flat] [all|thread index|thread name]");
+	COMMAND("profiler_locks", ProfilerLocksCommand, "Prints contention stats of named spinlocks (reset)");
+	COMMAND("profiler_stats", ProfilerStatsCommand, "Prints every scope aggregated over the history: profiler_stats [frame count|newest-oldest] [scope to show the histogram of]");
+	COMMAND("profiler_allocs", ProfilerAllocsCommand, "Counts allocations per scope, shown as extra report columns: profiler_allocs [on|off]");
+	COMMAND("profiler_counters", ProfilerCountersCommand, "Reads hardware counters (IPC, cache and branch miss rates) around scopes of a name: profiler_counters [scope] [on|off]");
+	COMMAND("profiler_sample", ProfilerSampleCommand, "Samples call stacks of every thread: profiler_sample [start [samples per second]|stop|clear], or profiler_sample [tree|flat] [all|thread index|thread name] to print them");
+	COMMAND("profiler_hitches", ProfilerHitchesCommand, "Lists frames that went over the budget, written to Log/ with the frames around them: profiler_hitches [clear], or profiler_hitches budget [milliseconds, 0 for off]");
+	COMMAND("profiler_export", ProfilerExportCommand, "Writes the frame history as a Chrome trace: profiler_export [file] [seconds to keep capturing], or profiler_export stop");
+	COMMAND("profiler_export_stats", ProfilerExportStatsCommand, "Writes every thread's scopes aggregated over the history: profiler_export_stats [file.csv|file.json]");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+Profiler::~Profiler()
+{
+	delete m_canvas;
+	m_canvas = nullptr;
+
+	ClearReports();
+	StopTraceCapture();
+	StopSampling();
+
+	// A hitch still taking frames is written with what it has
+	if(m_pendingHitch != nullptr && m_pendingHitch->GetHitchFrameCount() > 0)
+	{
+		FinishHitch();
+	}
+	ClearHitches();
+
+	for(auto& callTreeEntry : m_callTrees)
+	{
+		delete callTreeEntry.second;
+	}
+	m_callTrees.clear();
+
+	delete m_sampledArena;
+	m_sampledArena = nullptr;
+
+	// Samples go with their arenas
+	m_prevStacks.clear();
+
+	for(ProfilerFrameArena* arena : m_prevArenas)
+	{
+		delete arena;
+	}
+	m_prevArenas.clear();
+
+	delete m_activeArena;
+	m_activeArena = nullptr;
+
+	// Threads still holding a ProfilerThread register again if a profiler is created again
+	s_threadGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+	ProfilerThread* thread = m_threads.exchange(nullptr);
+	while(thread != nullptr)
+	{
+		ProfilerThread* next = thread->m_next;
+		delete thread;
+		thread = next;
+	}
+	m_mainThread = nullptr;
+
+	s_threadsLock.Enter();
+	s_threadNameCounts.clear();
+	s_threadsLock.Leave();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the start of a scope on the calling thread
+//
+void Profiler::PushProfile(const ProfilerScopeDesc* scope)
+{
+	GetCallingThread()->Push(scope);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the end of the calling thread's innermost scope
+//
+void Profiler::PopProfile()
+{
+	GetCallingThread()->Pop();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the calling thread's events, creating and registering them the first time
+//
+ProfilerThread* Profiler::GetCallingThread()
+{
+	uint32_t generation = s_threadGeneration.load(std::memory_order_acquire);
+
+	if(t_profilerThread.thread == nullptr || t_profilerThread.generation != generation)
+	{
+		t_profilerThread.thread = RegisterThread(ThreadGetName());
+		t_profilerThread.generation = generation;
+	}
+
+	return t_profilerThread.thread;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the calling thread to the list. Threads sharing a name are numbered so each gets its own view
+//
+ProfilerThread* Profiler::RegisterThread(const char* name)
+{
+	uintptr_t threadId = ThreadGetCurrentID();
+
+	s_threadsLock.Enter();
+
+	std::string uniqueName = name != nullptr ? name : Stringf("Thread %llu", (unsigned long long) threadId);
+	int& nameCount = s_threadNameCounts[uniqueName];
+	nameCount++;
+	if(nameCount > 1)
+	{
+		uniqueName += Stringf(" %d", nameCount);
+	}
+
+	ProfilerThread* thread = new ProfilerThread(uniqueName.c_str(), threadId);
+	thread->m_next = m_threads.load(std::memory_order_relaxed);
+	m_threads.store(thread, std::memory_order_release);
+
+	if(m_isSampling.load(std::memory_order_relaxed))
+	{
+		thread->m_sampler.Start(m_samplesPerSecond);
+	}
+
+	s_threadsLock.Leave();
+
+	return thread;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the names of the registered threads, main thread first and the rest in the order they registered
+//
+std::vector<std::string> Profiler::GetThreadNames() const
+{
+	std::vector<std::string> names;
+	for(ProfilerThread* thread = m_threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->m_next)
+	{
+		names.insert(names.begin(), thread->GetName());
+	}
+
+	return names;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pops the profiler stack
+//
+STATIC void Profiler::Pop()
+{
+	if(g_profiler != nullptr)
+	{
+		g_profiler->PopProfile();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Marks the frame start in the profiler
+//
+void Profiler::MarkFrame()
+{
+	g_profiler->StartProfileFrame();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Closes the profiler screen
+//
+void Profiler::Close()
+{
+	g_profiler->m_isProfilerOpen = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Opens the profiler screen
+//
+void Profiler::Open()
+{
+	if(g_profiler->m_canvas == nullptr)
+	{
+		g_profiler->CreateCanvas();
+	}
+
+	g_profiler->m_isProfilerOpen = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Handles click input when the user clicks on the graph
+//
+void Profiler::CPUGraphClickListener(int selectedIndex, MouseButton buttonCode)
+{
+	switch (buttonCode)
+	{
+	case MOUSE_LMB:
+		g_profiler->PauseProfiler();
+		g_profiler->m_selectedFrame = selectedIndex;
+		break;
+
+	case MOUSE_RMB:
+		g_profiler->ResumeProfiler();
+		g_profiler->m_selectedFrame = 0;
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to pause profiler
+//
+bool Profiler::PauseProfilerCommand(Command& cmd)
+{
+	g_profiler->PauseProfiler();
+
+	UNUSED(cmd);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to resume profiler
+//
+bool Profiler::ResumeProfilerCommand(Command& cmd)
+{
+	g_profiler->ResumeProfiler();
+
+	UNUSED(cmd);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to view the profiler reports
+//
+bool Profiler::ProfilerCommand(Command& cmd)
+{
+	if(g_profiler->IsProfilerOpen())
+	{
+		g_profiler->Close();
+	}
+	else
+	{
+		g_profiler->Open();
+	}
+
+	UNUSED(cmd);
+	return true;
 }
 
-//-----------------------------------------------------------------------------------------------
-// Destructor
-//
-Profiler::~Profiler()
-{
-	delete m_canvas;
-	m_canvas = nullptr;
+//-----------------------------------------------------------------------------------------------
+// Console command to print the last frame's report
+//
+bool Profiler::ProfilerReportCommand(Command& cmd)
+{
+	std::string reportTypeStr = cmd.GetNextString();
+
+	ReportType reportType;
+	if(reportTypeStr == "tree" || reportTypeStr == "")
+	{
+		reportType = REPORT_TYPE_TREE;
+	}
+	else if(reportTypeStr == "flat")
+	{
+		reportType = REPORT_TYPE_FLAT;
+	}
+	else
+	{
+		ConsolePrintf("'%s' Unsupported report type", reportTypeStr.c_str());
+		return false;
+	}
+
+	std::vector<std::string> threadNames;
+	if(!ResolveThreadArgument(cmd, &threadNames))
+	{
+		return false;
+	}
+
+	if(threadNames.empty())
+	{
+		g_profiler->PrintLastFrameToConsole(reportType);
+	}
+	for(const std::string& threadName : threadNames)
+	{
+		g_profiler->PrintLastFrameToConsole(reportType, threadName.c_str());
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to print the scope stats over the history, or part of it
+//
+bool Profiler::ProfilerStatsCommand(Command& cmd)
+{
+	int newestFrame = 0;
+	int oldestFrame = PROFILER_HISTORY_SIZE - 1;
+
+	std::string rangeStr = cmd.GetNextString();
+	std::string scopeId;
+	if(rangeStr != "" && rangeStr.find_first_not_of("0123456789-") == std::string::npos)
+	{
+		size_t dashIndex = rangeStr.find('-');
+		if(dashIndex == std::string::npos)
+		{
+			oldestFrame = atoi(rangeStr.c_str()) - 1;
+		}
+		else
+		{
+			newestFrame = atoi(rangeStr.substr(0, dashIndex).c_str());
+			oldestFrame = atoi(rangeStr.substr(dashIndex + 1).c_str());
+		}
+	}
+	else
+	{
+		scopeId = rangeStr;
+	}
+
+	// Scope names can have spaces, so the rest of the line is the name
+	for(std::string nextToken = cmd.GetNextString(); nextToken != ""; nextToken = cmd.GetNextString())
+	{
+		scopeId += scopeId.empty() ? nextToken : " " + nextToken;
+	}
+
+	if(newestFrame < 0 || oldestFrame < newestFrame || oldestFrame >= PROFILER_HISTORY_SIZE)
+	{
+		ConsolePrintf(Rgba::RED, "'%s' Bad frame range, frames go from 0 (last) to %d", rangeStr.c_str(), PROFILER_HISTORY_SIZE - 1);
+		return false;
+	}
+
+	ProfilerHistoryReport report;
+	g_profiler->GenerateHistoryReport(report, newestFrame, oldestFrame);
+	report.SortByTotalTime();
+	report.PrintReportToConsole(scopeId.empty() ? nullptr : scopeId.c_str());
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to write the profiler history as a Chrome trace, or capture the next few seconds
+//
+bool Profiler::ProfilerExportCommand(Command& cmd)
+{
+	std::string path = cmd.GetNextString();
+
+	if(path == "stop")
+	{
+		g_profiler->StopTraceCapture();
+		return true;
+	}
+
+	float seconds = 0.f;
+	if(path.find_first_not_of("0123456789.") == std::string::npos && path != "")
+	{
+		seconds = (float) atof(path.c_str());
+		path = "";
+	}
+	else
+	{
+		cmd.GetNextFloat(seconds);
+	}
+
+	if(path == "")
+	{
+		path = PROFILER_TRACE_FILE;
+	}
+
+	if(seconds > 0.f)
+	{
+		if(!g_profiler->StartTraceCapture(path.c_str(), seconds))
+		{
+			ConsolePrintf(Rgba::RED, "Couldn't create '%s'", path.c_str());
+			return false;
+		}
+
+		ConsolePrintf("Capturing %0.1f seconds to '%s'", seconds, path.c_str());
+		return true;
+	}
+
+	if(!g_profiler->ExportTrace(path.c_str()))
+	{
+		ConsolePrintf(Rgba::RED, "Couldn't create '%s'", path.c_str());
+		return false;
+	}
+
+	ConsolePrintf("Wrote the profiler history to '%s'", path.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to print or reset the spinlock contention stats
+//
+bool Profiler::ProfilerLocksCommand(Command& cmd)
+{
+	std::string option = cmd.GetNextString();
+
+	if(option == "reset")
+	{
+		SpinlockResetAllStats();
+		ConsolePrintf("Spinlock stats reset");
+	}
+	else if(option == "")
+	{
+		g_profiler->PrintLockStatsToConsole();
+	}
+	else
+	{
+		ConsolePrintf("'%s' Unsupported option", option.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts or stops counting allocations against the innermost scope, toggles without an option
+//
+bool Profiler::ProfilerAllocsCommand(Command& cmd)
+{
+#if defined(PROFILER_TRACK_ALLOCATIONS)
+	std::string option = cmd.GetNextString();
+
+	bool isTracking;
+	if(option == "on")
+	{
+		isTracking = true;
+	}
+	else if(option == "off")
+	{
+		isTracking = false;
+	}
+	else if(option == "")
+	{
+		isTracking = !ProfilerIsTrackingAllocations();
+	}
+	else
+	{
+		ConsolePrintf("'%s' Unsupported option", option.c_str());
+		return false;
+	}
+
+	ProfilerSetTrackAllocations(isTracking);
+	ConsolePrintf("Allocation tracking %s", isTracking ? "on" : "off");
+	return true;
+#else
+	ConsolePrintf("Allocation tracking needs PROFILER_TRACK_ALLOCATIONS");
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Picks the scopes that read the hardware counters, lists them without a scope
+//
+bool Profiler::ProfilerCountersCommand(Command& cmd)
+{
+	std::string scopeName = cmd.GetNextString();
+	std::string option = cmd.GetNextString();
+
+	if(scopeName == "")
+	{
+		std::vector<std::string> countedNames = ProfilerGetCountedScopeNames();
+		ConsolePrintf("Hardware counters %s, %d scopes counted", ProfilerCountersAreSupported() ? "supported" : "not supported on this platform", (int) countedNames.size());
+		for(const std::string& countedName : countedNames)
+		{
+			ConsolePrintf("  %s", countedName.c_str());
+		}
+		return true;
+	}
+
+	bool recordsCounters;
+	if(option == "on" || option == "")
+	{
+		recordsCounters = true;
+	}
+	else if(option == "off")
+	{
+		recordsCounters = false;
+	}
+	else
+	{
+		ConsolePrintf("'%s' Unsupported option", option.c_str());
+		return false;
+	}
+
+	ProfilerSetScopeCounters(scopeName.c_str(), recordsCounters);
+	ConsolePrintf("Hardware counters %s for '%s'", recordsCounters ? "on" : "off", scopeName.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to start, stop, clear or print the sampled call stacks
+//
+bool Profiler::ProfilerSampleCommand(Command& cmd)
+{
+	std::string option = cmd.GetNextString();
+
+	if(option == "start")
+	{
+		int samplesPerSecond = PROFILER_SAMPLER_DEFAULT_HZ;
+		cmd.GetNextInt(samplesPerSecond);
+
+		if(!g_profiler->StartSampling(samplesPerSecond))
+		{
+			ConsolePrintf(Rgba::RED, ProfilerSamplerIsSupported() ? "Couldn't start every sampling timer" : "Sampling is not supported on this platform");
+			return false;
+		}
+
+		ConsolePrintf("Sampling every thread %d times a second of CPU time", samplesPerSecond);
+		return true;
+	}
+
+	if(option == "stop")
+	{
+		g_profiler->StopSampling();
+		ConsolePrintf("Sampling stopped");
+		return true;
+	}
+
+	if(option == "clear")
+	{
+		g_profiler->DrainSamples();
+		g_profiler->ClearSampling();
+		ConsolePrintf("Samples cleared");
+		return true;
+	}
+
+	if(option == "")
+	{
+		ConsolePrintf("Sampling %s at %d a second", g_profiler->m_isSampling.load() ? "on" : "off", g_profiler->m_samplesPerSecond);
+		for(ProfilerThread* thread = g_profiler->m_threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->m_next)
+		{
+			auto callTreeIter = g_profiler->m_callTrees.find(thread->GetName());
+			uint64_t sampleCount = callTreeIter != g_profiler->m_callTrees.end() ? callTreeIter->second->GetSampleCount() : 0;
+			ConsolePrintf("  %s: %llu samples, %llu dropped", thread->GetName(), (unsigned long long) sampleCount, (unsigned long long) thread->m_sampler.GetDroppedSamples());
+		}
+		return true;
+	}
+
+	ReportType reportType;
+	if(option == "tree")
+	{
+		reportType = REPORT_TYPE_SAMPLED_TREE;
+	}
+	else if(option == "flat")
+	{
+		reportType = REPORT_TYPE_SAMPLED_FLAT;
+	}
+	else
+	{
+		ConsolePrintf("'%s' Unsupported option", option.c_str());
+		return false;
+	}
+
+	g_profiler->DrainSamples();
+
+	std::vector<std::string> threadNames;
+	if(!ResolveThreadArgument(cmd, &threadNames))
+	{
+		return false;
+	}
+
+	if(threadNames.empty())
+	{
+		g_profiler->PrintSampledReportToConsole(reportType);
+	}
+	for(const std::string& threadName : threadNames)
+	{
+		g_profiler->PrintSampledReportToConsole(reportType, threadName.c_str());
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Console command to write the scope stats of the history as CSV or JSON
+//
+bool Profiler::ProfilerExportStatsCommand(Command& cmd)
+{
+	std::string path = cmd.GetNextString();
+	if(path == "")
+	{
+		path = PROFILER_STATS_FILE;
+	}
+
+	if(!g_profiler->ExportStats(path.c_str()))
+	{
+		ConsolePrintf(Rgba::RED, "Couldn't create '%s'", path.c_str());
+		return false;
+	}
+
+	ConsolePrintf("Wrote the profiler stats to '%s'", path.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lists the hitches, clears them or sets the frame budget
+//
+bool Profiler::ProfilerHitchesCommand(Command& cmd)
+{
+	std::string option = cmd.GetNextString();
+
+	if(option == "budget")
+	{
+		float budgetMs = 0.f;
+		if(!cmd.GetNextFloat(budgetMs) || budgetMs < 0.f)
+		{
+			ConsolePrintf(Rgba::RED, "Expected a budget in milliseconds, 0 turns the alarm off");
+			return false;
+		}
+
+		g_profiler->SetFrameBudget(budgetMs);
+		if(budgetMs > 0.f)
+		{
+			ConsolePrintf("Frames over %0.2f ms are kept as hitches", budgetMs);
+		}
+		else
+		{
+			ConsolePrintf("Hitch alarm off");
+		}
+		return true;
+	}
+
+	if(option == "clear")
+	{
+		g_profiler->ClearHitches();
+		ConsolePrintf("Hitches cleared");
+		return true;
+	}
+
+	if(option == "")
+	{
+		g_profiler->PrintHitchesToConsole();
+		return true;
+	}
+
+	ConsolePrintf("'%s' Unsupported option", option.c_str());
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Marks the end of a frame and the start of the next. Builds the finished frame's tree for every
+// thread from what they recorded since the last mark
+//
+void Profiler::StartProfileFrame()
+{
+	uint64_t frameEndTicks = ProfilerGetTicks();
+
+	// Before any exited thread is freed below
+	DrainSamples();
+
+	if(m_frameStartTicks != 0)
+	{
+		ProfilerSample* mainRoot = m_mainThread->BuildFrame(*m_activeArena, s_frameScope, m_frameStartTicks, frameEndTicks);
+
+		// The other threads' roots follow the main thread's, threads that were idle all frame are left out
+		ProfilerSample* lastRoot = mainRoot;
+		ProfilerThread* prevThread = nullptr;
+		ProfilerThread* thread = m_threads.load(std::memory_order_acquire);
+		while(thread != nullptr)
+		{
+			ProfilerThread* nextThread = thread->m_next;
+
+			if(thread != m_mainThread)
+			{
+				// Read before draining, an exited thread can't record anything after it
+				bool isOrphaned = thread->IsOrphaned();
+
+				ProfilerSample* root = thread->BuildFrame(*m_activeArena, thread->GetRootScope(), m_frameStartTicks, frameEndTicks);
+				if(root->firstChild != nullptr)
+				{
+					lastRoot->nextSibling = root;
+					lastRoot = root;
+				}
+
+				// The head is left in place for RegisterThread to push in front of
+				if(prevThread != nullptr && isOrphaned && !thread->HasPendingEvents())
+				{
+					prevThread->m_next = nextThread;
+					delete thread;
+					thread = prevThread;
+				}
+			}
+
+			prevThread = thread;
+			thread = nextThread;
+		}
+
+		if(m_isPaused)
+		{
+			// The rings are still drained while paused, the frame just isn't kept
+			m_activeArena->Reset();
+		}
+		else
+		{
+			// The finished frame takes over the history slot's arena, the frame it replaces is released
+			// all at once and its arena records the next frame
+			std::swap(m_activeArena, m_prevArenas[m_prevFrameIndex]);
+			m_activeArena->Reset();
+
+			m_prevStacks[m_prevFrameIndex] = mainRoot;
+			FlightRecorderMarkFrame(mainRoot->GetElapsedSeconds() * 1000.0);
+			m_prevFrameIndex = (m_prevFrameIndex + 1) % PROFILER_HISTORY_SIZE;
+
+			if(m_traceCapture != nullptr)
+			{
+				m_traceCapture->WriteFrame(mainRoot);
+				if(frameEndTicks >= m_traceCaptureEndTicks)
+				{
+					StopTraceCapture();
+				}
+			}
+
+			CheckFrameBudget(mainRoot);
+		}
+	}
+
+	if(m_isReadyToPause)
+	{
+		m_isPaused = true;
+		m_isReadyToPause = false;
+	}
+
+	if(m_isReadyToResume)
+	{
+		m_isPaused = false;
+		m_isReadyToResume = false;
+	}
+
+	m_frameStartTicks = frameEndTicks;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the time a frame can take before it is kept as a hitch. A hitch still taking frames is
+// finished with what it has
+//
+void Profiler::SetFrameBudget(float milliseconds)
+{
+	if(m_pendingHitch != nullptr)
+	{
+		if(m_pendingHitch->GetHitchFrameCount() > 0)
+		{
+			FinishHitch();
+		}
+		else
+		{
+			delete m_pendingHitch;
+			m_pendingHitch = nullptr;
+		}
+	}
+
+	m_frameBudgetMs = milliseconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts a hitch when the frame went over the budget, with the frames before it from the history,
+// or adds the frame to the hitch taking the frames after one
+//
+void Profiler::CheckFrameBudget(ProfilerSample* mainRoot)
+{
+	m_frameNumber++;
+
+	// The last hitch's file write isn't the game's time
+	uint64_t writeTicks = m_hitchWriteTicks;
+	m_hitchWriteTicks = 0;
+
+	uint64_t frameTicks = mainRoot->endTicks - mainRoot->startTicks;
+	frameTicks -= writeTicks < frameTicks ? writeTicks : frameTicks;
+	double frameSeconds = ProfilerTicksToSeconds(frameTicks);
+
+	if(m_pendingHitch != nullptr)
+	{
+		// A full hitch is written even if frames are still slow, the next slow one starts another
+		m_pendingHitch->AddFrame(mainRoot, m_frameNumber, frameSeconds);
+		if(m_pendingHitch->IsComplete())
+		{
+			FinishHitch();
+		}
+		return;
+	}
+
+	if(m_frameBudgetMs <= 0.f)
+	{
+		return;
+	}
+
+	double frameMs = frameSeconds * 1000.0;
+	if(frameMs <= (double) m_frameBudgetMs)
+	{
+		return;
+	}
 
-	ClearReports();
+	ConsolePrintf(Rgba::YELLOW, "Hitch: frame %llu took %0.2f ms, over the %0.2f ms budget", (unsigned long long) m_frameNumber, frameMs, m_frameBudgetMs);
 
-	for(ProfilerSample* sample : m_prevStacks)
+	m_pendingHitch = new ProfilerHitch(PROFILER_HITCH_CONTEXT_FRAMES, PROFILER_HITCH_MAX_FRAMES, m_frameBudgetMs / 1000.0);
+	for(int skipCount = PROFILER_HITCH_CONTEXT_FRAMES; skipCount > 0; --skipCount)
 	{
-		delete sample;
-		sample = nullptr;
+		// The frame itself is the newest in the history
+		const ProfilerSample* prevRoot = GetPreviousFrame(skipCount);
+		if(prevRoot != nullptr && m_frameNumber > (uint64_t) skipCount)
+		{
+			m_pendingHitch->AddFrame(prevRoot, m_frameNumber - skipCount, prevRoot->GetElapsedSeconds());
+		}
 	}
-	m_prevStacks.clear();
+	m_pendingHitch->AddFrame(mainRoot, m_frameNumber, frameSeconds);
 
-	if(m_activeNode)
+	if(m_pendingHitch->IsComplete())
 	{
-		delete m_activeNode;
-		m_activeNode = nullptr;
+		FinishHitch();
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Creates a sample and pushes it to the stack
+// Writes the pending hitch to disk and keeps it if there is room left
 //
-void Profiler::PushProfile(char id[])
+void Profiler::FinishHitch()
 {
-	if(m_isPaused)
+	uint64_t writeStartTicks = ProfilerGetTicks();
+
+	ProfilerHitch* hitch = m_pendingHitch;
+	m_pendingHitch = nullptr;
+	m_hitchCount++;
+
+	std::string path = Stringf(PROFILER_HITCH_FILE, (unsigned long long) hitch->GetFirstHitchFrameNumber());
+	if(!hitch->WriteToFile(path.c_str()))
 	{
-		return;
+		ConsolePrintf(Rgba::RED, "Couldn't create '%s'", path.c_str());
+		path = "";
 	}
 
-	ProfilerSample* sample = CreateSample(id);
-
-	if(m_activeNode == nullptr)
+	if(m_hitches.size() < PROFILER_MAX_HITCHES)
 	{
-		m_activeNode = sample;
+		m_hitches.push_back(hitch);
+		m_hitchPaths.push_back(path);
 	}
 	else
 	{
-		sample->parent = m_activeNode;
-		m_activeNode->AddChild(sample);
-		m_activeNode = sample;
+		delete hitch;
 	}
+
+	m_hitchWriteTicks = ProfilerGetTicks() - writeStartTicks;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Pops the stack 
+// Frees every hitch kept, the pending one included. Files already written stay
 //
-void Profiler::PopProfile()
+void Profiler::ClearHitches()
 {
-	if(m_isPaused)
+	for(ProfilerHitch* hitch : m_hitches)
 	{
-		return; 
+		delete hitch;
 	}
+	m_hitches.clear();
+	m_hitchPaths.clear();
 
-	GUARANTEE_OR_DIE(m_activeNode != nullptr, "Called Pop without push");
+	delete m_pendingHitch;
+	m_pendingHitch = nullptr;
 
-	m_activeNode->Finish();
-	m_activeNode = m_activeNode->parent;
+	m_hitchCount = 0;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Pops the profiler stack
+// Prints the budget and every hitch kept
 //
-STATIC void Profiler::Pop()
+void Profiler::PrintHitchesToConsole() const
 {
-	g_profiler->PopProfile();
-}
+	if(m_frameBudgetMs > 0.f)
+	{
+		ConsolePrintf("Frame budget %0.2f ms, %d hitches, %u kept", m_frameBudgetMs, m_hitchCount, (unsigned int) m_hitches.size());
+	}
+	else
+	{
+		ConsolePrintf("Hitch alarm off, %d hitches, %u kept", m_hitchCount, (unsigned int) m_hitches.size());
+	}
 
-//-----------------------------------------------------------------------------------------------
-// Marks the frame start in the profiler
-//
-void Profiler::MarkFrame()
-{
-	g_profiler->StartProfileFrame();
-}
+	for(size_t hitchIndex = 0; hitchIndex < m_hitches.size(); ++hitchIndex)
+	{
+		const ProfilerHitch* hitch = m_hitches[hitchIndex];
+		ConsolePrintf("  Frame %llu: %d slow, worst %0.2f ms, %u frames in '%s'",
+			(unsigned long long) hitch->GetFirstHitchFrameNumber(),
+			hitch->GetHitchFrameCount(),
+			hitch->GetWorstFrameSeconds() * 1000.0,
+			(unsigned int) hitch->GetFrameCount(),
+			m_hitchPaths[hitchIndex].c_str());
+	}
 
-//-----------------------------------------------------------------------------------------------
-// Closes the profiler screen
-//
-void Profiler::Close()
-{
-	g_profiler->m_isProfilerOpen = false;
+	if(m_pendingHitch != nullptr)
+	{
+		ConsolePrintf("  Frame %llu: still taking frames", (unsigned long long) m_pendingHitch->GetFirstHitchFrameNumber());
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Opens the profiler screen
+// Writes every frame in the history to a Chrome trace file. Returns false if it can't be created
 //
-void Profiler::Open()
+bool Profiler::ExportTrace(const char* path)
 {
-	g_profiler->m_isProfilerOpen = true;
+	ProfilerTraceWriter writer;
+	if(!writer.Open(path))
+	{
+		return false;
+	}
+
+	// Oldest first, so the timeline reads left to right
+	std::vector<ProfilerSample*> frames = GetOrderedPreviousFrames();
+	for(ProfilerSample* frame : frames)
+	{
+		writer.WriteFrame(frame);
+	}
+
+	writer.Close();
+	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Handles click input when the user clicks on the graph
+// Writes the history report of every thread, for tracking scope timings outside the game. Returns
+// false if the file can't be created
 //
-void Profiler::CPUGraphClickListener(int selectedIndex, MouseButton buttonCode)
+bool Profiler::ExportStats(const char* path)
 {
-	switch (buttonCode)
+	size_t pathLength = strlen(path);
+	bool isJson = pathLength >= 5 && strcmp(path + pathLength - 5, ".json") == 0;
+
+	std::string statsText = isJson ? "{\"threads\": [" : PROFILER_STATS_CSV_HEADER;
+
+	std::vector<std::string> threadNames = GetThreadNames();
+	for(size_t threadIndex = 0; threadIndex < threadNames.size(); ++threadIndex)
 	{
-	case MOUSE_LMB:
-		g_profiler->PauseProfiler();
-		g_profiler->m_selectedFrame = selectedIndex;
-		break;
+		const char* threadName = threadNames[threadIndex].c_str();
 
-	case MOUSE_RMB:
-		g_profiler->ResumeProfiler();
-		g_profiler->m_selectedFrame = 0;
-		break;
+		ProfilerHistoryReport report;
+		GenerateHistoryReport(report, 0, PROFILER_HISTORY_SIZE - 1, threadName);
+		report.SortByTotalTime();
+
+		if(isJson)
+		{
+			statsText += threadIndex == 0 ? "\n\t" : ",\n\t";
+			report.AppendJson(threadName, statsText);
+		}
+		else
+		{
+			report.AppendCsvRows(threadName, statsText);
+		}
+	}
+
+	if(isJson)
+	{
+		statsText += "\n]}\n";
 	}
+
+	return FileWriteToNewFile(path, statsText.c_str(), statsText.size());
 }
 
 //-----------------------------------------------------------------------------------------------
-// Console command to pause profiler
+// Streams every frame recorded from now on to a Chrome trace file, for the given number of seconds
 //
-bool Profiler::PauseProfilerCommand(Command& cmd)
+bool Profiler::StartTraceCapture(const char* path, float seconds)
 {
-	g_profiler->PauseProfiler();
+	StopTraceCapture();
 
-	UNUSED(cmd);
+	m_traceCapture = new ProfilerTraceWriter();
+	if(!m_traceCapture->Open(path))
+	{
+		delete m_traceCapture;
+		m_traceCapture = nullptr;
+		return false;
+	}
+
+	m_traceCaptureEndTicks = ProfilerGetTicks() + ProfilerSecondsToTicks(seconds);
 	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Console command to resume profiler
+// Finishes the trace being captured, if any
 //
-bool Profiler::ResumeProfilerCommand(Command& cmd)
+void Profiler::StopTraceCapture()
 {
-	g_profiler->ResumeProfiler();
+	if(m_traceCapture == nullptr)
+	{
+		return;
+	}
 
-	UNUSED(cmd);
-	return true;
+	uint64_t frameCount = m_traceCapture->GetFrameCount();
+	m_traceCapture->Close();
+	delete m_traceCapture;
+	m_traceCapture = nullptr;
+
+	ConsolePrintf("Trace capture done, %llu frames", (unsigned long long) frameCount);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Console command to view the profiler reports
+// Starts sampling every registered thread, and every thread that registers while it runs
 //
-bool Profiler::ProfilerCommand(Command& cmd)
+bool Profiler::StartSampling(int samplesPerSecond)
 {
-	if(g_profiler->IsProfilerOpen())
+	if(!ProfilerSamplerIsSupported() || samplesPerSecond <= 0)
 	{
-		g_profiler->Close();
+		return false;
 	}
-	else
+
+	s_threadsLock.Enter();
+
+	m_samplesPerSecond = samplesPerSecond;
+	m_isSampling.store(true, std::memory_order_relaxed);
+
+	bool hasStarted = true;
+	for(ProfilerThread* thread = m_threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->m_next)
 	{
-		g_profiler->Open();
+		if(!thread->IsOrphaned())
+		{
+			hasStarted = thread->m_sampler.Start(samplesPerSecond) && hasStarted;
+		}
 	}
 
-	UNUSED(cmd);
-	return true;
+	s_threadsLock.Leave();
+
+	return hasStarted;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Console command to print the last frame's report
+// Stops the sampling timers, what was sampled stays until ClearSampling
 //
-bool Profiler::ProfilerReportCommand(Command& cmd)
+void Profiler::StopSampling()
 {
-	std::string reportType = cmd.GetNextString();
+	s_threadsLock.Enter();
 
-	if(reportType == "tree" || reportType == "")
-	{
-		g_profiler->PrintLastFrameToConsole(REPORT_TYPE_TREE);
-	}
-	else if(reportType == "flat")
-	{
-		g_profiler->PrintLastFrameToConsole(REPORT_TYPE_FLAT);
-	}
-	else
+	m_isSampling.store(false, std::memory_order_relaxed);
+	for(ProfilerThread* thread = m_threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->m_next)
 	{
-		ConsolePrintf("'%s' Unsupported report type", reportType.c_str());
-		return false;
+		thread->m_sampler.Stop();
 	}
 
-	return true;
+	s_threadsLock.Leave();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Creates a sample and returns it
+// Forgets every sampled stack
 //
-ProfilerSample* Profiler::CreateSample(char id[])
+void Profiler::ClearSampling()
 {
-	ProfilerSample* sample = new ProfilerSample(id);
-	return sample;
+	for(auto& callTreeEntry : m_callTrees)
+	{
+		callTreeEntry.second->Clear();
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Marks the start of a frame
+// Moves the stacks sampled since the last call into each thread's call tree
 //
-void Profiler::StartProfileFrame()
+void Profiler::DrainSamples()
 {
-	if(m_activeNode != nullptr)
+	for(ProfilerThread* thread = m_threads.load(std::memory_order_acquire); thread != nullptr; thread = thread->m_next)
 	{
-		if(m_prevStacks[m_prevFrameIndex] != nullptr)
+		ProfilerStackSample sample;
+		if(!thread->m_sampler.PopSample(&sample))
 		{
-			delete m_prevStacks[m_prevFrameIndex];
+			continue;
 		}
-		m_prevStacks[m_prevFrameIndex] = m_activeNode;
-		PopProfile();
-		m_prevFrameIndex = (m_prevFrameIndex + 1) % PROFILER_HISTORY_SIZE;
-	
-		GUARANTEE_OR_DIE(m_activeNode == nullptr, "Pushed without popping");
+
+		ProfilerCallTree*& callTree = m_callTrees[thread->GetName()];
+		if(callTree == nullptr)
+		{
+			callTree = new ProfilerCallTree();
+		}
+
+		do
+		{
+			callTree->AddStack(sample);
+		} while(thread->m_sampler.PopSample(&sample));
 	}
+}
 
-	if(m_isReadyToPause)
+//-----------------------------------------------------------------------------------------------
+// Builds the thread's call tree as samples, the main thread's if no name is given
+//
+ProfilerSample* Profiler::BuildSampledFrame(const char* threadName /*= nullptr */)
+{
+	if(threadName == nullptr || threadName[0] == '\0')
 	{
-		m_isPaused = true;
-		m_isReadyToPause = false;
-		return;
+		threadName = PROFILER_MAIN_THREAD_NAME;
 	}
 
-	if(m_isReadyToResume)
+	auto callTreeIter = m_callTrees.find(threadName);
+	if(callTreeIter == m_callTrees.end() || callTreeIter->second->GetSampleCount() == 0)
 	{
-		m_isPaused = false;
-		m_isReadyToResume = false;
+		return nullptr;
 	}
 
-	PushProfile(PROFILER_START_FRAME_TEXT);
+	m_sampledArena->Reset();
+	return callTreeIter->second->BuildSamples(*m_sampledArena, ProfilerRegisterScope(threadName));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints the thread's sampled call tree, slowest paths first
+//
+void Profiler::PrintSampledReportToConsole(ReportType type, const char* threadName /*= nullptr */)
+{
+	ProfilerSample* sampledRoot = BuildSampledFrame(threadName);
+	const char* shownName = threadName != nullptr ? threadName : PROFILER_MAIN_THREAD_NAME;
+	if(sampledRoot == nullptr)
+	{
+		ConsolePrintf("%s: no samples", shownName);
+		return;
+	}
+
+	ConsolePrintf("%s: %llu samples", shownName, (unsigned long long) m_callTrees[shownName]->GetSampleCount());
+	ProfilerReport* report = CreateReport(sampledRoot, type == REPORT_TYPE_SAMPLED_FLAT ? REPORT_TYPE_FLAT : REPORT_TYPE_TREE, SORT_BY_TOTAL_TIME);
+	report->PrintReportToConsole();
+	delete report;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -333,6 +1366,8 @@ void Profiler::UpdateReportBoxText()
 	// Most recent frame is at 0
 	std::vector<ProfilerSample*> prevFrames = GetOrderedPreviousFrames();
 
+	// The history and sampled views still need the frame reports for the graph and the status box
+	ReportType frameReportType = m_reportViewType == REPORT_TYPE_TREE ? REPORT_TYPE_TREE : REPORT_TYPE_FLAT;
 	for(ProfilerSample* sample : prevFrames)
 	{
 		if(sample == nullptr)
@@ -340,36 +1375,62 @@ void Profiler::UpdateReportBoxText()
 			break;
 		}
 
-		ProfilerReport* report = new ProfilerReport();
+		m_reports.push_back(CreateReport(sample, frameReportType, m_reportSortMode));
+	}
+
+	if(m_reportViewType == REPORT_TYPE_HISTORY)
+	{
+		ProfilerHistoryReport historyReport;
+		GenerateHistoryReport(historyReport, 0, PROFILER_HISTORY_SIZE - 1, m_selectedThreadName.c_str());
 
-		switch (m_reportViewType)
-		{
-		case REPORT_TYPE_FLAT:
-			report->GenerateFlatFromFrame(sample);
-			break;
-		case REPORT_TYPE_TREE:
-			report->GenerateTreeFromFrame(sample);
-			break;
-		default:
-			GUARANTEE_OR_DIE(false, "Wrong report frame type");
-			break;
-		}
-		
 		switch (m_reportSortMode)
 		{
-		case SORT_BY_NONE:			/* DO NOTHING */ 				break;
-		case SORT_BY_TOTAL_TIME:	report->SortByTotalTime();		break;
-		case SORT_BY_SELF_TIME:		report->SortBySelfTime(); 		break;
+		case SORT_BY_NONE:			/* DO NOTHING */ 					break;
+		case SORT_BY_TOTAL_TIME:	historyReport.SortByTotalTime();	break;
+		case SORT_BY_SELF_TIME:		historyReport.SortBySelfTime(); 	break;
 		default:
 			GUARANTEE_OR_DIE(false, "Bad report sort mode");
 			break;
 		}
 
-		m_reports.push_back(report);
+		std::string threadHeader = m_selectedThreadName.empty() ? "" : m_selectedThreadName + "\n";
+		m_reportBoxRef->SetText(threadHeader + historyReport.GetFormattedString());
+		return;
+	}
+
+	if(m_reportViewType == REPORT_TYPE_SAMPLED_TREE || m_reportViewType == REPORT_TYPE_SAMPLED_FLAT)
+	{
+		std::string threadHeader = m_selectedThreadName.empty() ? "" : m_selectedThreadName + "\n";
+		ProfilerSample* sampledRoot = BuildSampledFrame(m_selectedThreadName.c_str());
+		if(sampledRoot == nullptr)
+		{
+			m_reportBoxRef->SetText(threadHeader + "No samples, start sampling with profiler_sample start");
+			return;
+		}
+
+		ProfilerReport* sampledReport = CreateReport(sampledRoot, m_reportViewType == REPORT_TYPE_SAMPLED_TREE ? REPORT_TYPE_TREE : REPORT_TYPE_FLAT, m_reportSortMode);
+		m_reportBoxRef->SetText(threadHeader + sampledReport->GetFormattedString());
+		delete sampledReport;
+		return;
+	}
+
+	if(m_selectedThreadName.empty())
+	{
+		ProfilerReport* report = m_reports[m_selectedFrame];
+		m_reportBoxRef->SetText(report->GetFormattedString());
+		return;
+	}
+
+	ProfilerSample* threadRoot = FindThreadRoot(prevFrames[m_selectedFrame], m_selectedThreadName.c_str());
+	if(threadRoot == nullptr)
+	{
+		m_reportBoxRef->SetText(m_selectedThreadName + ": idle this frame");
+		return;
 	}
 
-	ProfilerReport* report = m_reports[m_selectedFrame];
-	m_reportBoxRef->SetText(report->GetFormattedString());
+	ProfilerReport* threadReport = CreateReport(threadRoot, m_reportViewType, m_reportSortMode);
+	m_reportBoxRef->SetText(m_selectedThreadName + "\n" + threadReport->GetFormattedString());
+	delete threadReport;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -396,7 +1457,42 @@ void Profiler::UpdateStatusBoxText()
 	
 	std::string fpsString = Stringf("FPS: %0.2f", fps) + "\n";
 	std::string frameTimeStr = Stringf("Frame Time: %0.4f ms", frameTime * 1000.0) + "\n";
-	m_statusBoxRef->SetText(fpsString + frameTimeStr);
+
+	// Time each of the other threads spent in scopes during the frame
+	std::string threadsStr;
+	ProfilerSample* mainRoot = GetOrderedPreviousFrames()[m_selectedFrame];
+	for(ProfilerSample* root = mainRoot != nullptr ? mainRoot->nextSibling : nullptr; root != nullptr; root = root->nextSibling)
+	{
+		double busyTime = root->GetChildrenTotalTime();
+		threadsStr += Stringf("%s: %0.4f ms (%0.1f%%)", root->GetName(), busyTime * 1000.0, frameTime > 0.0 ? 100.0 * busyTime / frameTime : 0.0) + "\n";
+	}
+
+	std::string hitchesStr = m_frameBudgetMs > 0.f ? Stringf("Hitches over %0.1f ms: %d", m_frameBudgetMs, m_hitchCount) + "\n" : "";
+
+	m_statusBoxRef->SetText(fpsString + frameTimeStr + hitchesStr + threadsStr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints the acquisition and contention counters of every named spinlock
+//
+void Profiler::PrintLockStatsToConsole() const
+{
+	std::vector<SpinlockStatsSnapshot> lockStats;
+	SpinlockGetAllStats(lockStats);
+
+	ConsolePrintf("%-24s %14s %14s %9s %16s %12s", "LOCK", "ACQUIRES", "CONTENDED", "CONT %", "SPIN CYCLES", "CYCLES/WAIT");
+
+	for(const SpinlockStatsSnapshot& stats : lockStats)
+	{
+		uint64_t acquisitions = stats.acquisitions;
+		uint64_t contended = stats.contendedAcquisitions;
+		uint64_t spinCycles = stats.spinCycles;
+
+		double contendedPercent = acquisitions > 0 ? 100.0 * (double) contended / (double) acquisitions : 0.0;
+		double cyclesPerWait = contended > 0 ? (double) spinCycles / (double) contended : 0.0;
+
+		ConsolePrintf("%-24s %14llu %14llu %8.2f%% %16llu %12.0f", stats.name.c_str(), (unsigned long long) acquisitions, (unsigned long long) contended, contendedPercent, (unsigned long long) spinCycles, cyclesPerWait);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -404,7 +1500,18 @@ void Profiler::UpdateStatusBoxText()
 //
 void Profiler::UpdateControlsBoxText()
 {
-	std::string ReportViewText = Stringf("Toggle ReportView [V]: %s\n", m_reportViewType == REPORT_TYPE_TREE ? "TREE VIEW" : "FLAT VIEW");
+	std::string viewTypeStr;
+	switch (m_reportViewType)
+	{
+	case REPORT_TYPE_FLAT:		viewTypeStr = "FLAT VIEW";		break;
+	case REPORT_TYPE_TREE:		viewTypeStr = "TREE VIEW";		break;
+	case REPORT_TYPE_HISTORY:	viewTypeStr = "HISTORY VIEW";	break;
+	case REPORT_TYPE_SAMPLED_TREE:	viewTypeStr = m_isSampling.load() ? "SAMPLED TREE VIEW" : "SAMPLED TREE VIEW (STOPPED)";	break;
+	case REPORT_TYPE_SAMPLED_FLAT:	viewTypeStr = m_isSampling.load() ? "SAMPLED FLAT VIEW" : "SAMPLED FLAT VIEW (STOPPED)";	break;
+	default:					viewTypeStr = "BAD STRING";		break;
+	}
+
+	std::string ReportViewText = Stringf("Toggle ReportView [V]: %s\n", viewTypeStr.c_str());
 	std::string MouseText = Stringf("Enable/Disable Mouse [M]: %s\n", m_hasMouseControl ? "Enabled" : "Disabled");
 
 	std::string sortModeStr;
@@ -417,7 +1524,8 @@ void Profiler::UpdateControlsBoxText()
 	}
 
 	std::string SortText = Stringf("Toggle Sort modes [L]: %s \n", sortModeStr.c_str());
-	std::string controlsText =  ReportViewText + MouseText + SortText;
+	std::string ThreadText = Stringf("Cycle Threads [T]: %s\n", m_selectedThreadName.empty() ? PROFILER_MAIN_THREAD_NAME : m_selectedThreadName.c_str());
+	std::string controlsText =  ReportViewText + MouseText + SortText + ThreadText;
 	m_controlsBoxRef->SetText(controlsText);
 }
 
@@ -449,13 +1557,38 @@ void Profiler::Render() const
 	m_canvas->Render();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Creates the profiler screen's widgets
+//
+void Profiler::CreateCanvas()
+{
+	m_canvas = new Canvas();
+	m_reportBoxRef = m_canvas->AddTextBox("reportBox", Vector2::ZERO, Vector2(1.f, 0.7f), "test");
+	m_controlsBoxRef = m_canvas->AddTextBox("controlsBox", Vector2(0.f, 0.72f), Vector2(0.4f, 0.82f), "controlsBox");
+	m_statusBoxRef = m_canvas->AddTextBox("statusBox", Vector2(0.f, 0.84f), Vector2(0.4f, 0.94f), "statusBox");
+	
+	m_graphBoxRef = m_canvas->AddAreaGraph("usageGraph", Vector2(0.5f, 0.72f), Vector2(1.f, 0.94f), {});
+	m_graphBoxRef->SetOnClick(CPUGraphClickListener);
+	m_graphBoxRef->SetThresholds(18.f, 22.f); // FPS: 55, 45
+}
+
 //-----------------------------------------------------------------------------------------------
 // Prints the last frame's report to console
 //
-void Profiler::PrintLastFrameToConsole(ReportType type)
+void Profiler::PrintLastFrameToConsole(ReportType type, const char* threadName /*= nullptr */)
 {
+	ProfilerSample* prevFrame = GetPreviousFrameOfThread(threadName, 0);
+	if(threadName != nullptr)
+	{
+		ConsolePrintf(prevFrame != nullptr ? "%s:" : "%s: idle last frame", threadName);
+	}
+
+	if(prevFrame == nullptr)
+	{
+		return;
+	}
+
 	ProfilerReport report;
-	ProfilerSample* prevFrame = GetPreviousFrame(0);
 	switch (type)
 	{
 	case REPORT_TYPE_FLAT:
@@ -473,6 +1606,25 @@ void Profiler::PrintLastFrameToConsole(ReportType type)
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+// Aggregates the thread's frames from newestFrame to oldestFrame back, 0 being the last frame.
+// Frames the thread was idle in are left out
+//
+void Profiler::GenerateHistoryReport(ProfilerHistoryReport& outReport, int newestFrame, int oldestFrame, const char* threadName /*= nullptr */)
+{
+	newestFrame = ClampInt(newestFrame, 0, PROFILER_HISTORY_SIZE - 1);
+	oldestFrame = ClampInt(oldestFrame, newestFrame, PROFILER_HISTORY_SIZE - 1);
+
+	// Oldest first, like the graph
+	std::vector<const ProfilerSample*> roots;
+	for(int skipCount = oldestFrame; skipCount >= newestFrame; --skipCount)
+	{
+		roots.push_back(GetPreviousFrameOfThread(threadName, skipCount));
+	}
+
+	outReport.Generate(roots);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Destroys the reports
 //
@@ -503,6 +1655,22 @@ void Profiler::ProcessInput()
 		m_reportSortMode = (ReportSortMode) ((m_reportSortMode + 1) % NUM_SORT_MODES);
 	}
 
+	if(input->WasKeyJustPressed(KEYCODE_T))
+	{
+		// Main thread, then every other thread in the order they registered
+		std::vector<std::string> threadNames = GetThreadNames();
+		std::string currentName = m_selectedThreadName.empty() ? PROFILER_MAIN_THREAD_NAME : m_selectedThreadName;
+
+		size_t threadIndex = 0;
+		while(threadIndex < threadNames.size() && threadNames[threadIndex] != currentName)
+		{
+			threadIndex++;
+		}
+
+		threadIndex = threadIndex + 1 < threadNames.size() ? threadIndex + 1 : 0;
+		m_selectedThreadName = threadIndex > 0 ? threadNames[threadIndex] : "";
+	}
+
 	if(input->WasKeyJustPressed(KEYCODE_M))
 	{
 		
@@ -531,14 +1699,6 @@ void Profiler::ProcessMouseInput()
 
 }
 
-//-----------------------------------------------------------------------------------------------
-// Returns the top node
-// 
-ProfilerSample* Profiler::GetTop() const
-{
-	return m_activeNode;
-}
-
 //-----------------------------------------------------------------------------------------------
 // Returns true if the profiler is paused
 // 
@@ -570,6 +1730,20 @@ ProfilerSample* Profiler::GetPreviousFrame(int skipCount /*= 0 */)
 	return m_prevStacks[actualIndex];
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the given thread's root in the n-th previous frame, null if it was idle. No name means
+// the main thread
+//
+ProfilerSample* Profiler::GetPreviousFrameOfThread(const char* threadName, int skipCount /*= 0 */)
+{
+	if(threadName != nullptr && strcmp(threadName, PROFILER_MAIN_THREAD_NAME) == 0)
+	{
+		threadName = nullptr;
+	}
+
+	return FindThreadRoot(GetPreviousFrame(skipCount), threadName);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns the n-th previous frame, 0 meaning immediate previous
 //
@@ -623,9 +1797,23 @@ STATIC Profiler* Profiler::GetInstance()
 //-----------------------------------------------------------------------------------------------
 // Pushes a new sample
 //
-STATIC void Profiler::Push(char id[])
+STATIC void Profiler::Push(const ProfilerScopeDesc* scope)
+{
+	if(g_profiler != nullptr)
+	{
+		g_profiler->PushProfile(scope);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes a new sample for a name only known at runtime
+//
+STATIC void Profiler::Push(const char* name)
 {
-	g_profiler->PushProfile(id);
+	if(g_profiler != nullptr)
+	{
+		g_profiler->PushProfile(ProfilerRegisterScope(name));
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -646,9 +1834,11 @@ void ProfilerShutdown()
 
 #else
 #pragma warning(disable:4100)
-		ProfilerSample*					Profiler::GetTop() const { return nullptr; }
 		const	ProfilerSample*			Profiler::GetPreviousFrame( int skipCount ) const{ return nullptr; }
 		ProfilerSample*					Profiler::GetPreviousFrame( int skipCount ) { return nullptr; }
+		ProfilerSample*					Profiler::GetPreviousFrameOfThread( const char* threadName, int skipCount ) { return nullptr; }
+		ProfilerThread*					Profiler::GetCallingThread() { return nullptr; }
+		std::vector<std::string>		Profiler::GetThreadNames() const { return {}; }
 		bool							Profiler::IsPaused() const { return false; }
 		bool							Profiler::IsProfilerOpen() const { return false; }
 		
@@ -657,26 +1847,53 @@ void ProfilerShutdown()
 		void							Profiler::UpdateStatusBoxText( float deltaSeconds ) {}
 		void							Profiler::UpdateControlsBoxText() {}
 		void							Profiler::UpdateGraphBoxValues() {}
-		void							Profiler::PrintLastFrameToConsole( ReportType type ){}
+		void							Profiler::PrintLastFrameToConsole( ReportType type, const char* threadName ){}
+		void							Profiler::PrintLockStatsToConsole() const {}
 		void							Profiler::ClearReports() {}
 		void							Profiler::ProcessInput(){}
 		void							Profiler::ProcessMouseInput() {}
-		void							Profiler::PushProfile( char id[] ) {}
+		void							Profiler::PushProfile( const ProfilerScopeDesc* scope ) {}
 		void							Profiler::PopProfile() {}
-		ProfilerSample*					Profiler::CreateSample( char id[] ) { return nullptr; }
+		ProfilerThread*					Profiler::RegisterThread( const char* name ) { return nullptr; }
 		void							Profiler::StartProfileFrame() {}
 		void							Profiler::PauseProfiler() {}
 		void							Profiler::ResumeProfiler() {}
 		void							Profiler::Update( float deltaSeconds ) {}
 		void							Profiler::Render() const {}
+		void							Profiler::CreateCanvas() {}
 		Profiler*						Profiler::CreateInstance() { return nullptr; }
 		void							Profiler::DestroyInstance() {}
 		Profiler*						Profiler::GetInstance() {  return nullptr; }
-		void							Profiler::Push( char id[] ) {}
+		void							Profiler::Push( const ProfilerScopeDesc* scope ) {}
+		void							Profiler::Push( const char* name ) {}
 		void							Profiler::Pop() {}
 		void							Profiler::MarkFrame() {}
 		bool							Profiler::PauseProfilerCommand( Command& cmd ) { return false; }
 		bool							Profiler::ResumeProfilerCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerLocksCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerExportCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerExportStatsCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerStatsCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerAllocsCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerCountersCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerSampleCommand( Command& cmd ) { return false; }
+		bool							Profiler::ProfilerHitchesCommand( Command& cmd ) { return false; }
+		bool							Profiler::StartSampling( int samplesPerSecond ) { return false; }
+		void							Profiler::StopSampling() {}
+		void							Profiler::ClearSampling() {}
+		void							Profiler::DrainSamples() {}
+		ProfilerSample*					Profiler::BuildSampledFrame( const char* threadName ) { return nullptr; }
+		void							Profiler::PrintSampledReportToConsole( ReportType type, const char* threadName ) {}
+		void							Profiler::SetFrameBudget( float milliseconds ) {}
+		void							Profiler::CheckFrameBudget( ProfilerSample* mainRoot ) {}
+		void							Profiler::FinishHitch() {}
+		void							Profiler::ClearHitches() {}
+		void							Profiler::PrintHitchesToConsole() const {}
+		void							Profiler::GenerateHistoryReport( ProfilerHistoryReport& outReport, int newestFrame, int oldestFrame, const char* threadName ) {}
+		bool							Profiler::ExportTrace( const char* path ) { return false; }
+		bool							Profiler::ExportStats( const char* path ) { return false; }
+		bool							Profiler::StartTraceCapture( const char* path, float seconds ) { return false; }
+		void							Profiler::StopTraceCapture() {}
 		void							Profiler::CPUGraphClickListener( int selectedIndex, MouseButton buttonCode ) {}
 
 		void							ProfilerStartup() {}
@@ -1,5 +1,11 @@
 #pragma once
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Engine/Core/EngineConfig.hpp"
 #include "Engine/Profiler/ProfilerSample.hpp"
+#include "Engine/Profiler/ProfilerScope.hpp"
 #include "Engine/Profiler/ProfileLogScope.hpp"
 #include "Engine/Enumerations/ReportType.hpp"
 #include "Engine/Enumerations/ReportSortMode.hpp"
@@ -7,7 +13,13 @@
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Command;
+class ProfilerCallTree;
+class ProfilerFrameArena;
+class ProfilerHitch;
 class ProfilerReport;
+class ProfilerHistoryReport;
+class ProfilerThread;
+class ProfilerTraceWriter;
 class Canvas;
 class Widget_Textbox;
 class Widget_AreaGraph;
@@ -24,17 +36,19 @@ public:
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-			ProfilerSample*					GetTop() const;
 	const	ProfilerSample*					GetPreviousFrame( int skipCount = 0 ) const;
 			ProfilerSample*					GetPreviousFrame( int skipCount = 0 );
+			ProfilerSample*					GetPreviousFrameOfThread( const char* threadName, int skipCount = 0 ); // Null if the thread was idle
+			ProfilerThread*					GetCallingThread(); // Registers the calling thread on first use
+			std::vector<std::string>		GetThreadNames() const;
 			bool							IsPaused() const;
 			bool							IsProfilerOpen() const;
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
-			void							PushProfile( char id[] );
+			void							PushProfile( const ProfilerScopeDesc* scope );
 			void							PopProfile();
-			ProfilerSample*					CreateSample( char id[] );
+			ProfilerThread*					RegisterThread( const char* name );
 			void							StartProfileFrame();
 			void							PauseProfiler();
 			void							ResumeProfiler();
@@ -45,7 +59,25 @@ public:
 			void							UpdateControlsBoxText();
 			void							UpdateGraphBoxValues();
 			void							Render() const;
-			void							PrintLastFrameToConsole( ReportType type );
+			void							CreateCanvas(); // On first open, so a profiler that is never shown needs no UI
+			void							PrintLastFrameToConsole( ReportType type, const char* threadName = nullptr );
+			void							GenerateHistoryReport( ProfilerHistoryReport& outReport, int newestFrame, int oldestFrame, const char* threadName = nullptr ); // Frames counted back from the last one
+			void							PrintLockStatsToConsole() const;
+			bool							ExportTrace( const char* path ); // Every frame in the history, as a Chrome trace
+			bool							ExportStats( const char* path ); // Every thread's scopes aggregated over the history, JSON for a .json path and CSV otherwise
+			bool							StartTraceCapture( const char* path, float seconds ); // Streams the frames to come
+			void							StopTraceCapture();
+			bool							StartSampling( int samplesPerSecond ); // Samples every thread's call stack until StopSampling
+			void							StopSampling();
+			void							ClearSampling();
+			void							DrainSamples();
+			ProfilerSample*					BuildSampledFrame( const char* threadName = nullptr ); // Thread's call tree as samples, null if it has none. Valid until the next call
+			void							PrintSampledReportToConsole( ReportType type, const char* threadName = nullptr );
+			void							SetFrameBudget( float milliseconds ); // 0 turns the hitch alarm off
+			void							CheckFrameBudget( ProfilerSample* mainRoot ); // Called with every frame kept in the history
+			void							FinishHitch();
+			void							ClearHitches();
+			void							PrintHitchesToConsole() const;
 			void							ClearReports();
 			void							ProcessInput();
 			void							ProcessMouseInput();
@@ -55,7 +87,8 @@ public:
 	static	Profiler*						CreateInstance();
 	static	void							DestroyInstance();
 	static	Profiler*						GetInstance();
-	static	void							Push( char id[] );
+	static	void							Push( const ProfilerScopeDesc* scope );
+	static	void							Push( const char* name ); // Looks the scope up on every call, prefer PROFILE_LOG_SCOPE
 	static	void							Pop();
 	static	void							MarkFrame();
 	static	void							Close();
@@ -71,26 +104,52 @@ public:
 	static	bool							ResumeProfilerCommand( Command& cmd );
 	static	bool							ProfilerCommand( Command& cmd );
 	static	bool							ProfilerReportCommand( Command& cmd );
+	static	bool							ProfilerLocksCommand( Command& cmd );
+	static	bool							ProfilerExportCommand( Command& cmd );
+	static	bool							ProfilerExportStatsCommand( Command& cmd );
+	static	bool							ProfilerStatsCommand( Command& cmd );
+	static	bool							ProfilerAllocsCommand( Command& cmd );
+	static	bool							ProfilerCountersCommand( Command& cmd );
+	static	bool							ProfilerSampleCommand( Command& cmd );
+	static	bool							ProfilerHitchesCommand( Command& cmd );
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
-			ProfilerSample*					m_activeNode = nullptr;
-			std::vector<ProfilerSample*>	m_prevStacks;
+			std::atomic<ProfilerThread*>	m_threads{nullptr}; // Every thread that has profiled a scope, newest first
+			ProfilerThread*					m_mainThread = nullptr;
+			uint64_t						m_frameStartTicks = 0;
+			std::vector<ProfilerSample*>	m_prevStacks; // Main thread's root, the other threads' roots follow it as its siblings
+			std::vector<ProfilerFrameArena*>	m_prevArenas; // Owns the samples of the frame in the same history slot
+			ProfilerFrameArena*				m_activeArena = nullptr; // Frame being recorded
 			unsigned int					m_prevFrameIndex = 0;
 			bool							m_isReadyToPause = false;
 			bool							m_isReadyToResume = false;
 			bool							m_isPaused = false;
 			bool							m_isProfilerOpen = false;
-			Canvas*							m_canvas;
+			Canvas*							m_canvas = nullptr;
 			std::vector<ProfilerReport*>	m_reports;
-			Widget_Textbox*					m_statusBoxRef;
-			Widget_Textbox*					m_controlsBoxRef;
-			Widget_Textbox*					m_reportBoxRef;
-			Widget_AreaGraph*				m_graphBoxRef;
+			Widget_Textbox*					m_statusBoxRef = nullptr;
+			Widget_Textbox*					m_controlsBoxRef = nullptr;
+			Widget_Textbox*					m_reportBoxRef = nullptr;
+			Widget_AreaGraph*				m_graphBoxRef = nullptr;
 			ReportType						m_reportViewType = REPORT_TYPE_TREE;
 			bool							m_hasMouseControl = false;
 			ReportSortMode					m_reportSortMode = SORT_BY_NONE;
 			int								m_selectedFrame = 0;
+			std::string						m_selectedThreadName; // Thread shown in the report box, empty for the main thread
+			ProfilerTraceWriter*			m_traceCapture = nullptr; // Frames are streamed to it while capturing
+			uint64_t						m_traceCaptureEndTicks = 0;
+			std::atomic<bool>				m_isSampling{false}; // Threads registering while it is set start sampling too
+			int								m_samplesPerSecond = PROFILER_SAMPLER_DEFAULT_HZ;
+			std::unordered_map<std::string, ProfilerCallTree*>	m_callTrees; // By thread name, kept after the thread exits
+			ProfilerFrameArena*				m_sampledArena = nullptr; // Holds the samples BuildSampledFrame returned last
+			float							m_frameBudgetMs = PROFILER_FRAME_BUDGET_MS;
+			uint64_t						m_frameNumber = 0; // Frames kept in the history so far
+			ProfilerHitch*					m_pendingHitch = nullptr; // Still taking the frames after its slow one
+			std::vector<ProfilerHitch*>		m_hitches; // The first PROFILER_MAX_HITCHES, never replaced
+			std::vector<std::string>		m_hitchPaths; // Where each kept hitch was written
+			int								m_hitchCount = 0; // Kept or not
+			uint64_t						m_hitchWriteTicks = 0; // Writing the last hitch out, not held against the frame it lands in
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -100,5 +159,8 @@ void	ProfilerShutdown();
 
 //-----------------------------------------------------------------------------------------------
 // PROFILER MACROS
-#define PROFILE_LOG_SCOPE(tag)				ProfileLogScope __timer_ ##__LINE__ ## (tag);
+#define PROFILE_CONCAT_INNER(a, b)			a ## b
+#define PROFILE_CONCAT(a, b)				PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_LOG_SCOPE(tag)				static const ProfilerScopeDesc* PROFILE_CONCAT(__scope_, __LINE__) = ProfilerRegisterScope(tag, __FILE__, __LINE__); \
+											ProfileLogScope PROFILE_CONCAT(__timer_, __LINE__)(PROFILE_CONCAT(__scope_, __LINE__));
 #define PROFILE_LOG_SCOPE_FUNCTION()		PROFILE_LOG_SCOPE(__FUNCTION__);
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "Engine/Profiler/ProfilerAllocations.hpp"
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static std::atomic<bool> s_isTrackingAllocations{false};
+
+#if defined(PROFILER_TRACK_ALLOCATIONS)
+//-----------------------------------------------------------------------------------------------
+// Globals
+thread_local ProfilerAllocations t_profilerAllocations = { 0, 0 }; // Constant initialized, safe to touch from inside new
+
+//-----------------------------------------------------------------------------------------------
+// Counts the allocation against the calling thread
+//
+static void* TrackedAlloc(size_t size)
+{
+	if(s_isTrackingAllocations.load(std::memory_order_relaxed))
+	{
+		t_profilerAllocations.count++;
+		t_profilerAllocations.bytes += (uint32_t) size;
+	}
+
+	return malloc(size != 0 ? size : 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Global new/delete, replaced for the whole program. Frees aren't counted, a scope only reports
+// what it allocated
+//
+void* operator new(size_t size)
+{
+	void* memory = TrackedAlloc(size);
+	if(memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	void* memory = TrackedAlloc(size);
+	if(memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Starts or stops counting allocations
+//
+void ProfilerSetTrackAllocations(bool isTracking)
+{
+	s_isTrackingAllocations.store(isTracking, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true while allocations are being counted
+//
+bool ProfilerIsTrackingAllocations()
+{
+#if defined(PROFILER_TRACK_ALLOCATIONS)
+	return s_isTrackingAllocations.load(std::memory_order_relaxed);
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Core/EngineConfig.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Running totals of what a thread has allocated through global new. Both wrap, only differences
+// between two reads on the same thread mean anything
+struct ProfilerAllocations
+{
+	uint32_t	count;
+	uint32_t	bytes;
+};
+
+#if defined(PROFILER_TRACK_ALLOCATIONS)
+extern thread_local ProfilerAllocations t_profilerAllocations;
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void	ProfilerSetTrackAllocations( bool isTracking ); // Off by default, the hooks only count while on
+bool	ProfilerIsTrackingAllocations();
+
+//-----------------------------------------------------------------------------------------------
+// Returns the calling thread's totals, zero if allocations aren't hooked
+//
+inline ProfilerAllocations ProfilerGetThreadAllocations()
+{
+#if defined(PROFILER_TRACK_ALLOCATIONS)
+	return t_profilerAllocations;
+#else
+	return { 0, 0 };
+#endif
+}
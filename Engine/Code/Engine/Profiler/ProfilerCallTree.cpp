@@ -0,0 +1,163 @@
+#include "Engine/Profiler/ProfilerCallTree.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Profiler/ProfilerClock.hpp"
+#include "Engine/Profiler/ProfilerFrameArena.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+#include "Engine/Profiler/ProfilerSampler.hpp"
+#include "Engine/Profiler/ProfilerScope.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#if defined(__linux__)
+	#include <cxxabi.h>
+	#include <dlfcn.h>
+#endif
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static std::unordered_map<void*, const ProfilerScopeDesc*>			s_functionsByAddress; // Profiler thread only, symbols are looked up once per address
+static std::unordered_map<const void*, const ProfilerScopeDesc*>	s_functionsByStart; // Profiler thread only, one scope per function start or per module
+
+//-----------------------------------------------------------------------------------------------
+// Returns the scope of the function the address is in. Symbols come from dladdr, so functions of
+// the executable only have names when it is linked with -rdynamic. Without one every address in
+// the module shares the module's scope, so scopes stay bounded by the code that was sampled
+//
+static const ProfilerScopeDesc* ResolveFunction(void* address)
+{
+	auto functionIter = s_functionsByAddress.find(address);
+	if(functionIter != s_functionsByAddress.end())
+	{
+		return functionIter->second;
+	}
+
+	const void* functionStart = nullptr;
+	std::string functionName = "[unknown]";
+#if defined(__linux__)
+	Dl_info symbolInfo;
+	if(dladdr(address, &symbolInfo) != 0)
+	{
+		const char* moduleName = symbolInfo.dli_fname != nullptr ? strrchr(symbolInfo.dli_fname, '/') : nullptr;
+		moduleName = moduleName != nullptr ? moduleName + 1 : (symbolInfo.dli_fname != nullptr ? symbolInfo.dli_fname : "[unknown]");
+
+		if(symbolInfo.dli_saddr != nullptr)
+		{
+			functionStart = symbolInfo.dli_saddr;
+			if(symbolInfo.dli_sname != nullptr)
+			{
+				int demangleStatus = 0;
+				char* demangledName = abi::__cxa_demangle(symbolInfo.dli_sname, nullptr, nullptr, &demangleStatus);
+				functionName = demangleStatus == 0 ? demangledName : symbolInfo.dli_sname;
+				free(demangledName);
+			}
+			else
+			{
+				functionName = Stringf("%s+0x%llx", moduleName, (unsigned long long) ((uintptr_t) symbolInfo.dli_saddr - (uintptr_t) symbolInfo.dli_fbase));
+			}
+		}
+		else
+		{
+			functionStart = symbolInfo.dli_fbase;
+			functionName = moduleName;
+		}
+	}
+#endif
+
+	const ProfilerScopeDesc*& function = s_functionsByStart[functionStart];
+	if(function == nullptr)
+	{
+		function = ProfilerRegisterScope(functionName.c_str());
+	}
+
+	s_functionsByAddress[address] = function;
+	return function;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns the node and everything under it into samples, each as long as the CPU time sampled in it
+//
+static ProfilerSample* BuildNodeSamples(const ProfilerCallTree& tree, int nodeIndex, ProfilerFrameArena& arena, const ProfilerScopeDesc* scope)
+{
+	const ProfilerCallTree::Node& node = tree.m_nodes[nodeIndex];
+
+	ProfilerSample* sample = arena.CreateSample(scope);
+	sample->startTicks = 0;
+	sample->endTicks = ProfilerSecondsToTicks(node.seconds);
+
+	for(int childIndex : node.children)
+	{
+		sample->AddChild(BuildNodeSamples(tree, childIndex, arena, tree.m_nodes[childIndex].function));
+	}
+
+	return sample;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerCallTree::ProfilerCallTree()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the stack from the outermost frame in, merging with the paths already there
+//
+void ProfilerCallTree::AddStack(const ProfilerStackSample& sample)
+{
+	double seconds = (double) sample.cpuNanoseconds * 1e-9;
+
+	int nodeIndex = 0;
+	m_nodes[0].sampleCount++;
+	m_nodes[0].seconds += seconds;
+
+	for(int frameIndex = (int) sample.frameCount - 1; frameIndex >= 0; --frameIndex)
+	{
+		const ProfilerScopeDesc* function = ResolveFunction(sample.frames[frameIndex]);
+
+		int childNodeIndex = -1;
+		for(int childIndex : m_nodes[nodeIndex].children)
+		{
+			if(m_nodes[childIndex].function == function)
+			{
+				childNodeIndex = childIndex;
+				break;
+			}
+		}
+
+		if(childNodeIndex < 0)
+		{
+			childNodeIndex = (int) m_nodes.size();
+			m_nodes.push_back({ function, 0, 0.0, {} });
+			m_nodes[nodeIndex].children.push_back(childNodeIndex);
+		}
+
+		nodeIndex = childNodeIndex;
+		m_nodes[nodeIndex].sampleCount++;
+		m_nodes[nodeIndex].seconds += seconds;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Forgets every sample
+//
+void ProfilerCallTree::Clear()
+{
+	m_nodes.clear();
+	m_nodes.push_back({ nullptr, 0, 0.0, {} });
+}
+
+//-----------------------------------------------------------------------------------------------
+// Builds the tree as samples in the arena, under a root named by rootScope
+//
+ProfilerSample* ProfilerCallTree::BuildSamples(ProfilerFrameArena& arena, const ProfilerScopeDesc* rootScope) const
+{
+	return BuildNodeSamples(*this, 0, arena, rootScope);
+}
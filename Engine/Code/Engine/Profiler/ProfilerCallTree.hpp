@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class ProfilerFrameArena;
+struct ProfilerSample;
+struct ProfilerScopeDesc;
+struct ProfilerStackSample;
+
+//-----------------------------------------------------------------------------------------------
+// Stack samples of one thread merged by function into a call tree. Functions become profiler scopes
+// named after their symbols, so the tree can be turned into samples for the usual reports
+class ProfilerCallTree
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerCallTree();
+	~ProfilerCallTree() {}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			uint64_t		GetSampleCount() const { return m_nodes[0].sampleCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void			AddStack( const ProfilerStackSample& sample );
+			void			Clear();
+			ProfilerSample*	BuildSamples( ProfilerFrameArena& arena, const ProfilerScopeDesc* rootScope ) const; // Each node lasts the CPU time sampled in it
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	struct Node
+	{
+		const ProfilerScopeDesc*	function;
+		uint64_t					sampleCount; // Stacks that went through it
+		double						seconds; // CPU time those stacks stand for
+		std::vector<int>			children;
+	};
+
+	std::vector<Node>	m_nodes; // Root first, it stands for the thread
+};
@@ -0,0 +1,131 @@
+#include "Engine/Profiler/ProfilerClock.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/Thread.hpp"
+#include "Engine/Core/Time.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#if defined(PROFILER_CLOCK_HAS_TSC) && !defined(_MSC_VER)
+	#include <cpuid.h>
+#endif
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Globals
+bool g_profilerClockUsesTsc = false;
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static bool		s_isClockStarted = false;
+#if defined(_WIN32)
+static double	s_secondsPerTick = 0.0; // Set at startup, the performance counter's rate
+#else
+static double	s_secondsPerTick = 1.0 / 1000000000.0; // Nanoseconds from clock_gettime
+#endif
+
+#if defined(PROFILER_CLOCK_HAS_TSC)
+//-----------------------------------------------------------------------------------------------
+// Returns true if the cycle counter runs at a constant rate on every core and in every power state
+//
+static bool HasInvariantTsc()
+{
+#if defined(_MSC_VER)
+	int registers[4];
+	__cpuid(registers, 0x80000000);
+	if((unsigned int) registers[0] < 0x80000007)
+	{
+		return false;
+	}
+
+	__cpuid(registers, 0x80000007);
+	return (registers[3] & (1 << 8)) != 0;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if(!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+	{
+		return false;
+	}
+
+	return (edx & (1u << 8)) != 0;
+#endif
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Picks the tick source. The cycle counter is timed against the performance counter over
+// PROFILER_TSC_CALIBRATION_MS, which only happens once
+//
+void ProfilerClockStartup()
+{
+	if(s_isClockStarted)
+	{
+		return;
+	}
+	s_isClockStarted = true;
+
+	Time::CreateInstance();
+
+#if defined(_WIN32)
+	s_secondsPerTick = Time::HpcToSeconds(1);
+#endif
+
+#if defined(PROFILER_CLOCK_HAS_TSC)
+	if(HasInvariantTsc())
+	{
+		uint64_t startHpc = Time::GetPerformanceCounter();
+		uint64_t startTsc = __rdtsc();
+
+		ThreadSleep(PROFILER_TSC_CALIBRATION_MS);
+
+		uint64_t endHpc = Time::GetPerformanceCounter();
+		uint64_t endTsc = __rdtsc();
+
+		double elapsedSeconds = Time::HpcToSeconds(endHpc - startHpc);
+		if(elapsedSeconds > 0.0 && endTsc > startTsc)
+		{
+			s_secondsPerTick = elapsedSeconds / (double) (endTsc - startTsc);
+			g_profilerClockUsesTsc = true;
+		}
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if ticks come from the cycle counter
+//
+bool ProfilerClockUsesTsc()
+{
+	return g_profilerClockUsesTsc;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Converts ticks to seconds
+//
+double ProfilerTicksToSeconds(uint64_t ticks)
+{
+	return (double) ticks * s_secondsPerTick;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Converts seconds to ticks
+//
+uint64_t ProfilerSecondsToTicks(double seconds)
+{
+	return (uint64_t) (seconds / s_secondsPerTick);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ticks without the cycle counter
+//
+uint64_t ProfilerGetFallbackTicks()
+{
+#if defined(_WIN32)
+	return Time::GetPerformanceCounter();
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Core/EngineConfig.hpp"
+#if defined(PROFILER_USE_TSC) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+	#define PROFILER_CLOCK_HAS_TSC
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+#if !defined(_WIN32)
+	#include <time.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Timestamps for profiler scopes. Reads the CPU's cycle counter where it is invariant (constant rate
+// across cores and power states), calibrated once against the performance counter at startup.
+// Otherwise CLOCK_MONOTONIC_RAW on POSIX and the performance counter on Windows. Ticks from
+// different sources don't mix, so the source is picked once before anything is profiled
+extern bool g_profilerClockUsesTsc;
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void		ProfilerClockStartup(); // Picks the source and calibrates it, later calls do nothing
+bool		ProfilerClockUsesTsc();
+double		ProfilerTicksToSeconds( uint64_t ticks );
+uint64_t	ProfilerSecondsToTicks( double seconds );
+uint64_t	ProfilerGetFallbackTicks();
+
+//-----------------------------------------------------------------------------------------------
+// Returns the current tick. May be read before earlier instructions finish, which suits the start
+// of a scope
+//
+inline uint64_t ProfilerGetTicks()
+{
+#if defined(PROFILER_CLOCK_HAS_TSC)
+	if(g_profilerClockUsesTsc)
+	{
+		return __rdtsc();
+	}
+#endif
+
+#if defined(_WIN32)
+	return ProfilerGetFallbackTicks();
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the current tick once every earlier instruction has finished, for the end of a scope
+//
+inline uint64_t ProfilerGetTicksAfter()
+{
+#if defined(PROFILER_CLOCK_HAS_TSC)
+	if(g_profilerClockUsesTsc)
+	{
+		unsigned int processorId;
+		return __rdtscp(&processorId);
+	}
+#endif
+
+	return ProfilerGetTicks();
+}
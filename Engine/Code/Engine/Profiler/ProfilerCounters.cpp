@@ -0,0 +1,196 @@
+#include "Engine/Profiler/ProfilerCounters.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Returns instructions retired per cycle, 0 if nothing was counted
+//
+double ProfilerCounterValues::GetInstructionsPerCycle() const
+{
+	uint64_t cycles = values[PROFILER_COUNTER_CYCLES];
+	return cycles != 0 ? (double) values[PROFILER_COUNTER_INSTRUCTIONS] / (double) cycles : 0.0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the fraction of cache references that missed
+//
+double ProfilerCounterValues::GetCacheMissRate() const
+{
+	uint64_t references = values[PROFILER_COUNTER_CACHE_REFERENCES];
+	return references != 0 ? (double) values[PROFILER_COUNTER_CACHE_MISSES] / (double) references : 0.0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the fraction of branches that were mispredicted
+//
+double ProfilerCounterValues::GetBranchMissRate() const
+{
+	uint64_t branches = values[PROFILER_COUNTER_BRANCHES];
+	return branches != 0 ? (double) values[PROFILER_COUNTER_BRANCH_MISSES] / (double) branches : 0.0;
+}
+
+#if defined(__linux__)
+//-----------------------------------------------------------------------------------------------
+// Linux Implementation
+//-----------------------------------------------------------------------------------------------
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------------------------
+// Event config of each ProfilerCounterType
+static const uint64_t s_counterConfigs[NUM_PROFILER_COUNTERS] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_REFERENCES,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+	PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+//-----------------------------------------------------------------------------------------------
+// Opens one user space counter of the calling thread, in the leader's group unless it is the leader
+//
+static int OpenCounter(uint64_t config, int groupFd)
+{
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING; // Times tell whether the group was on the PMU
+	attr.disabled = groupFd < 0 ? 1 : 0; // The group starts together once every member is in
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	return (int) syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerCounterGroup::ProfilerCounterGroup()
+{
+	for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex)
+	{
+		m_fds[counterIndex] = -1;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+ProfilerCounterGroup::~ProfilerCounterGroup()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Opens every counter as one group on the calling thread. If any of them is missing (no PMU in a
+// VM, perf_event_paranoid too strict) none are used
+//
+bool ProfilerCounterGroup::Open()
+{
+	if(m_hasTriedOpen)
+	{
+		return IsOpen();
+	}
+	m_hasTriedOpen = true;
+
+	for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex)
+	{
+		m_fds[counterIndex] = OpenCounter(s_counterConfigs[counterIndex], m_fds[0]);
+		if(m_fds[counterIndex] < 0)
+		{
+			Close();
+			return false;
+		}
+	}
+
+	ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Closes the counters, members before the leader
+//
+void ProfilerCounterGroup::Close()
+{
+	for(int counterIndex = NUM_PROFILER_COUNTERS - 1; counterIndex >= 0; --counterIndex)
+	{
+		if(m_fds[counterIndex] >= 0)
+		{
+			close(m_fds[counterIndex]);
+			m_fds[counterIndex] = -1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads the whole group with one syscall. Returns false if the group never got onto the PMU (more
+// events than free counters), and scales the values up if it only ran part of the time
+//
+bool ProfilerCounterGroup::Read(ProfilerCounterValues* outValues) const
+{
+	if(!IsOpen())
+	{
+		return false;
+	}
+
+	uint64_t groupValues[3 + NUM_PROFILER_COUNTERS]; // Counter count, time enabled, time running, then the counters in the order they were opened
+	if(read(m_fds[0], groupValues, sizeof(groupValues)) != (ssize_t) sizeof(groupValues))
+	{
+		return false;
+	}
+
+	// The read still succeeds with zeros when the group couldn't be scheduled
+	uint64_t timeEnabled = groupValues[1];
+	uint64_t timeRunning = groupValues[2];
+	if(timeRunning == 0)
+	{
+		return false;
+	}
+
+	for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex)
+	{
+		uint64_t value = groupValues[3 + counterIndex];
+		if(timeRunning < timeEnabled)
+		{
+			// Multiplexed with other events, estimate the full count like perf stat does
+			value = (uint64_t) ((double) value * (double) timeEnabled / (double) timeRunning);
+		}
+		outValues->values[counterIndex] = value;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if this platform can count
+//
+bool ProfilerCountersAreSupported()
+{
+	return true;
+}
+
+#else
+//-----------------------------------------------------------------------------------------------
+// Other platforms have no counters the profiler can read
+//-----------------------------------------------------------------------------------------------
+		ProfilerCounterGroup::ProfilerCounterGroup() { for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex) { m_fds[counterIndex] = -1; } }
+		ProfilerCounterGroup::~ProfilerCounterGroup() {}
+bool	ProfilerCounterGroup::Open() { m_hasTriedOpen = true; return false; }
+void	ProfilerCounterGroup::Close() {}
+bool	ProfilerCounterGroup::Read( ProfilerCounterValues* outValues ) const { UNUSED(outValues); return false; }
+bool	ProfilerCountersAreSupported() { return false; }
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Enumerations/ProfilerCounterType.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+struct ProfilerCounterValues
+{
+	uint64_t	values[NUM_PROFILER_COUNTERS];
+
+	double		GetInstructionsPerCycle() const;
+	double		GetCacheMissRate() const; // Of cache references
+	double		GetBranchMissRate() const; // Of branches
+};
+
+//-----------------------------------------------------------------------------------------------
+// The hardware counters of one thread, read together so the values line up. Only Linux has them,
+// through perf_event_open; elsewhere Open fails and scopes are timed without counters
+class ProfilerCounterGroup
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerCounterGroup();
+	~ProfilerCounterGroup();
+
+	ProfilerCounterGroup( const ProfilerCounterGroup& ) = delete;
+	ProfilerCounterGroup& operator=( const ProfilerCounterGroup& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool	IsOpen() const { return m_fds[0] >= 0; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool	Open(); // Counts the calling thread. Only tries once, returns true if the counters are running
+			void	Close();
+			bool	Read( ProfilerCounterValues* outValues ) const; // Totals since Open
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	int		m_fds[NUM_PROFILER_COUNTERS]; // First is the group leader
+	bool	m_hasTriedOpen = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+bool	ProfilerCountersAreSupported();
@@ -0,0 +1,71 @@
+#include "Engine/Profiler/ProfilerFrameArena.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <new>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+ProfilerFrameArena::~ProfilerFrameArena()
+{
+	for(ProfilerSample* block : m_blocks)
+	{
+		::operator delete(block);
+	}
+	m_blocks.clear();
+
+	for(ProfilerCounterValues* block : m_counterBlocks)
+	{
+		delete[] block;
+	}
+	m_counterBlocks.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructs a sample in the next free slot, adding a block when the ones we have are full
+//
+ProfilerSample* ProfilerFrameArena::CreateSample(const ProfilerScopeDesc* scope)
+{
+	size_t blockIndex = m_sampleCount / PROFILER_ARENA_BLOCK_SAMPLES;
+	if(blockIndex == m_blocks.size())
+	{
+		m_blocks.push_back((ProfilerSample*) ::operator new(sizeof(ProfilerSample) * PROFILER_ARENA_BLOCK_SAMPLES));
+	}
+
+	ProfilerSample* slot = m_blocks[blockIndex] + m_sampleCount % PROFILER_ARENA_BLOCK_SAMPLES;
+	m_sampleCount++;
+
+	return new (slot) ProfilerSample(scope);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the counters into the next free slot, adding a block when the ones we have are full
+//
+ProfilerCounterValues* ProfilerFrameArena::CreateCounters(const ProfilerCounterValues& values)
+{
+	size_t blockIndex = m_counterCount / PROFILER_ARENA_BLOCK_SAMPLES;
+	if(blockIndex == m_counterBlocks.size())
+	{
+		m_counterBlocks.push_back(new ProfilerCounterValues[PROFILER_ARENA_BLOCK_SAMPLES]);
+	}
+	ProfilerCounterValues* slot = m_counterBlocks[blockIndex] + m_counterCount % PROFILER_ARENA_BLOCK_SAMPLES;
+	m_counterCount++;
+	*slot = values;
+	return slot;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Releases every sample at once. Samples own nothing, so there is nothing to destruct
+//
+void ProfilerFrameArena::Reset()
+{
+	m_sampleCount = 0;
+	m_counterCount = 0;
+}
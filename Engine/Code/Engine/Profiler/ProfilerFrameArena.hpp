@@ -0,0 +1,43 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+struct ProfilerCounterValues;
+struct ProfilerSample;
+struct ProfilerScopeDesc;
+
+//-----------------------------------------------------------------------------------------------
+// Owns every sample of one profiled frame. Samples are handed out from blocks of
+// PROFILER_ARENA_BLOCK_SAMPLES and all released at once by Reset, which keeps the blocks for the
+// next frame, so a warmed up profiler doesn't touch the allocator
+class ProfilerFrameArena
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerFrameArena() {}
+	~ProfilerFrameArena();
+
+	ProfilerFrameArena( const ProfilerFrameArena& ) = delete;
+	ProfilerFrameArena& operator=( const ProfilerFrameArena& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			size_t				GetSampleCount() const { return m_sampleCount; }
+			size_t				GetCounterCount() const { return m_counterCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			ProfilerSample*		CreateSample( const ProfilerScopeDesc* scope );
+			ProfilerCounterValues*	CreateCounters( const ProfilerCounterValues& values ); // For counted samples, from blocks of their own
+			void				Reset(); // Every sample handed out so far is gone
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::vector<ProfilerSample*>	m_blocks;
+	size_t							m_sampleCount = 0;
+	std::vector<ProfilerCounterValues*>	m_counterBlocks;
+	size_t							m_counterCount = 0;
+};
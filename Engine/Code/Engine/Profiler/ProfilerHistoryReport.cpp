@@ -0,0 +1,339 @@
+#include "Engine/Profiler/ProfilerHistoryReport.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Console/DevConsole.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+#include "Engine/Profiler/ProfilerScope.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <algorithm>
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define HISTOGRAM_BAR_WIDTH		40
+
+//-----------------------------------------------------------------------------------------------
+// Returns mean, min, max and percentiles of the values
+//
+static ProfilerTimeStats ComputeTimeStats(const std::vector<double>& values)
+{
+	ProfilerTimeStats stats;
+	if(values.empty())
+	{
+		return stats;
+	}
+
+	std::vector<double> sortedValues = values;
+	std::sort(sortedValues.begin(), sortedValues.end());
+
+	double sum = 0.0;
+	for(double value : sortedValues)
+	{
+		sum += value;
+	}
+
+	size_t lastIndex = sortedValues.size() - 1;
+	stats.mean = sum / (double) sortedValues.size();
+	stats.min = sortedValues.front();
+	stats.max = sortedValues.back();
+	stats.p95 = sortedValues[(size_t) (0.95 * (double) lastIndex + 0.5)];
+	stats.p99 = sortedValues[(size_t) (0.99 * (double) lastIndex + 0.5)];
+	return stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the text as a CSV field, quoted if it has a comma, quote or line break in it
+//
+static void AppendCsvField(std::string& outCsv, const char* text)
+{
+	if(strpbrk(text, ",\"\r\n") == nullptr)
+	{
+		outCsv += text;
+		return;
+	}
+
+	outCsv += '"';
+	for(const char* character = text; *character != '\0'; ++character)
+	{
+		if(*character == '"')
+		{
+			outCsv += '"';
+		}
+		outCsv += *character;
+	}
+	outCsv += '"';
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the stats in ms as "name": {...} members of a JSON object
+//
+static std::string GetJsonTimeStats(const char* name, const ProfilerTimeStats& stats)
+{
+	return Stringf("\"%s\": {\"mean\": %0.6f, \"min\": %0.6f, \"max\": %0.6f, \"p95\": %0.6f, \"p99\": %0.6f}", name,
+		stats.mean * 1000.0, stats.min * 1000.0, stats.max * 1000.0, stats.p95 * 1000.0, stats.p99 * 1000.0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the scope's stats, null if it never showed up
+//
+const ProfilerScopeStats* ProfilerHistoryReport::FindScope(const char* name) const
+{
+	auto scopeIter = m_scopeIndices.find(ProfilerFindScopeName(name));
+	if(scopeIter == m_scopeIndices.end())
+	{
+		return nullptr;
+	}
+
+	return &m_scopes[scopeIter->second];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Aggregates the frames. Null roots are skipped
+//
+void ProfilerHistoryReport::Generate(const std::vector<const ProfilerSample*>& roots)
+{
+	m_scopes.clear();
+	m_scopeIndices.clear();
+	m_frameCount = 0;
+
+	std::vector<int> frameScopes; // Scopes seen in the frame being collected
+	for(const ProfilerSample* root : roots)
+	{
+		if(root == nullptr)
+		{
+			continue;
+		}
+
+		frameScopes.clear();
+		CollectSample(root, frameScopes);
+
+		for(int scopeIndex : frameScopes)
+		{
+			m_scopes[scopeIndex].frameCount++;
+		}
+
+		m_frameCount++;
+	}
+
+	for(ProfilerScopeStats& scope : m_scopes)
+	{
+		scope.totalTime = ComputeTimeStats(scope.frameTotalTimes);
+		scope.selfTime = ComputeTimeStats(scope.frameSelfTimes);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the sample and its children to this frame's sums
+//
+void ProfilerHistoryReport::CollectSample(const ProfilerSample* sample, std::vector<int>& frameScopes)
+{
+	auto scopeIter = m_scopeIndices.find(sample->GetName());
+	if(scopeIter == m_scopeIndices.end())
+	{
+		scopeIter = m_scopeIndices.emplace(sample->GetName(), m_scopes.size()).first;
+		m_scopes.emplace_back();
+		m_scopes.back().id = sample->GetName();
+	}
+
+	int scopeIndex = (int) scopeIter->second;
+	ProfilerScopeStats& scope = m_scopes[scopeIndex];
+
+	// First call this frame starts the frame's sums
+	if(scope.lastFrameIndex != m_frameCount)
+	{
+		scope.lastFrameIndex = m_frameCount;
+		scope.frameTotalTimes.push_back(0.0);
+		scope.frameSelfTimes.push_back(0.0);
+		frameScopes.push_back(scopeIndex);
+	}
+
+	double totalTime = sample->GetElapsedSeconds();
+	scope.callCount++;
+	scope.frameTotalTimes.back() += totalTime;
+	scope.frameSelfTimes.back() += totalTime - sample->GetChildrenTotalTime();
+
+	for(const ProfilerSample* child = sample->firstChild; child != nullptr; child = child->nextSibling)
+	{
+		CollectSample(child, frameScopes);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sorts the scopes by their mean total time, the root stays first
+//
+void ProfilerHistoryReport::SortByTotalTime()
+{
+	if(m_scopes.size() > 1)
+	{
+		std::stable_sort(m_scopes.begin() + 1, m_scopes.end(), [](const ProfilerScopeStats& a, const ProfilerScopeStats& b) { return a.totalTime.mean > b.totalTime.mean; });
+	}
+
+	for(size_t scopeIndex = 0; scopeIndex < m_scopes.size(); ++scopeIndex)
+	{
+		m_scopeIndices[m_scopes[scopeIndex].id] = scopeIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sorts the scopes by their mean self time, the root stays first
+//
+void ProfilerHistoryReport::SortBySelfTime()
+{
+	if(m_scopes.size() > 1)
+	{
+		std::stable_sort(m_scopes.begin() + 1, m_scopes.end(), [](const ProfilerScopeStats& a, const ProfilerScopeStats& b) { return a.selfTime.mean > b.selfTime.mean; });
+	}
+
+	for(size_t scopeIndex = 0; scopeIndex < m_scopes.size(); ++scopeIndex)
+	{
+		m_scopeIndices[m_scopes[scopeIndex].id] = scopeIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One line per scope, times in ms
+//
+void ProfilerHistoryReport::GetLines(std::vector<std::string>& outLines) const
+{
+	outLines.push_back(Stringf("%d frames", m_frameCount));
+	outLines.push_back(Stringf("%-32s %6s %7s | %-44s | %-44s", "SCOPE", "FRAMES", "CALLS", "TOTAL ms  mean/min/max/p95/p99", "SELF ms  mean/min/max/p95/p99"));
+
+	for(const ProfilerScopeStats& scope : m_scopes)
+	{
+		const ProfilerTimeStats& total = scope.totalTime;
+		const ProfilerTimeStats& self = scope.selfTime;
+
+		outLines.push_back(Stringf("%-32.32s %6d %7d | %8.3f %8.3f %8.3f %8.3f %8.3f | %8.3f %8.3f %8.3f %8.3f %8.3f",
+			scope.id, scope.frameCount, scope.callCount,
+			total.mean * 1000.0, total.min * 1000.0, total.max * 1000.0, total.p95 * 1000.0, total.p99 * 1000.0,
+			self.mean * 1000.0, self.min * 1000.0, self.max * 1000.0, self.p95 * 1000.0, self.p99 * 1000.0));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Histogram of the scope's total time per frame, PROFILER_HISTOGRAM_BUCKETS even buckets from its
+// min to its max
+//
+void ProfilerHistoryReport::GetHistogramLines(const ProfilerScopeStats& scope, std::vector<std::string>& outLines) const
+{
+	outLines.push_back(Stringf("%s total time per frame:", scope.id));
+	if(scope.frameTotalTimes.empty())
+	{
+		return;
+	}
+
+	double minTime = scope.totalTime.min;
+	double bucketSize = (scope.totalTime.max - minTime) / (double) PROFILER_HISTOGRAM_BUCKETS;
+
+	int bucketCounts[PROFILER_HISTOGRAM_BUCKETS] = {};
+	for(double time : scope.frameTotalTimes)
+	{
+		int bucketIndex = bucketSize > 0.0 ? (int) ((time - minTime) / bucketSize) : 0;
+		bucketCounts[std::min(bucketIndex, PROFILER_HISTOGRAM_BUCKETS - 1)]++;
+	}
+
+	int maxCount = *std::max_element(bucketCounts, bucketCounts + PROFILER_HISTOGRAM_BUCKETS);
+	for(int bucketIndex = 0; bucketIndex < PROFILER_HISTOGRAM_BUCKETS; ++bucketIndex)
+	{
+		double bucketStart = minTime + bucketSize * (double) bucketIndex;
+		int barLength = maxCount > 0 ? (bucketCounts[bucketIndex] * HISTOGRAM_BAR_WIDTH + maxCount - 1) / maxCount : 0;
+
+		outLines.push_back(Stringf("%8.3f - %8.3f ms | %-*s %d", bucketStart * 1000.0, (bucketStart + bucketSize) * 1000.0,
+			HISTOGRAM_BAR_WIDTH, std::string(barLength, '#').c_str(), bucketCounts[bucketIndex]));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the report text followed by the histogram of the root (Ready to render)
+//
+std::string ProfilerHistoryReport::GetFormattedString() const
+{
+	std::vector<std::string> lines;
+	GetLines(lines);
+
+	if(!m_scopes.empty())
+	{
+		lines.push_back("");
+		GetHistogramLines(m_scopes.front(), lines);
+	}
+
+	std::string formattedText;
+	for(const std::string& line : lines)
+	{
+		formattedText.append(line + "\n");
+	}
+
+	return formattedText;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints the report and one histogram to console
+//
+void ProfilerHistoryReport::PrintReportToConsole(const char* histogramScopeId /*= nullptr */) const
+{
+	std::vector<std::string> lines;
+	GetLines(lines);
+
+	const ProfilerScopeStats* histogramScope = histogramScopeId != nullptr ? FindScope(histogramScopeId) : (m_scopes.empty() ? nullptr : &m_scopes.front());
+	if(histogramScope != nullptr)
+	{
+		GetHistogramLines(*histogramScope, lines);
+	}
+	else if(histogramScopeId != nullptr)
+	{
+		lines.push_back(Stringf("'%s' wasn't recorded in these frames", histogramScopeId));
+	}
+
+	for(const std::string& line : lines)
+	{
+		ConsolePrintf("%s", line.c_str());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends a row per scope, in the report's order
+//
+void ProfilerHistoryReport::AppendCsvRows(const char* threadName, std::string& outCsv) const
+{
+	for(const ProfilerScopeStats& scope : m_scopes)
+	{
+		const ProfilerTimeStats& total = scope.totalTime;
+		const ProfilerTimeStats& self = scope.selfTime;
+
+		AppendCsvField(outCsv, threadName);
+		outCsv += ',';
+		AppendCsvField(outCsv, scope.id);
+		outCsv += Stringf(",%d,%d,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f,%0.6f\n",
+			scope.frameCount, scope.callCount,
+			total.mean * 1000.0, total.min * 1000.0, total.max * 1000.0, total.p95 * 1000.0, total.p99 * 1000.0,
+			self.mean * 1000.0, self.min * 1000.0, self.max * 1000.0, self.p95 * 1000.0, self.p99 * 1000.0);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends {"thread": ..., "frames": ..., "scopes": [...]}, times in ms
+//
+void ProfilerHistoryReport::AppendJson(const char* threadName, std::string& outJson) const
+{
+	outJson += "{\"thread\": ";
+	AppendJsonString(outJson, threadName);
+	outJson += Stringf(", \"frames\": %d, \"scopes\": [", m_frameCount);
+
+	for(size_t scopeIndex = 0; scopeIndex < m_scopes.size(); ++scopeIndex)
+	{
+		const ProfilerScopeStats& scope = m_scopes[scopeIndex];
+
+		outJson += scopeIndex == 0 ? "\n\t\t{\"scope\": " : ",\n\t\t{\"scope\": ";
+		AppendJsonString(outJson, scope.id);
+		outJson += Stringf(", \"frames\": %d, \"calls\": %d, ", scope.frameCount, scope.callCount);
+		outJson += GetJsonTimeStats("total_ms", scope.totalTime) + ", " + GetJsonTimeStats("self_ms", scope.selfTime) + "}";
+	}
+
+	outJson += "\n\t]}";
+}
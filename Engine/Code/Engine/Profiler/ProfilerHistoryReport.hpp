@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+struct ProfilerSample;
+
+//-----------------------------------------------------------------------------------------------
+// Distribution of one scope's time per frame, in seconds
+struct ProfilerTimeStats
+{
+	double	mean = 0.0;
+	double	min = 0.0;
+	double	max = 0.0;
+	double	p95 = 0.0;
+	double	p99 = 0.0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// One scope over a run of frames. Times are summed per frame, so a scope called 3 times in a frame
+// counts as one value
+struct ProfilerScopeStats
+{
+	const char*				id = nullptr; // Interned scope name
+	int						frameCount = 0; // Frames the scope showed up in
+	int						callCount = 0;
+	std::vector<double>		frameTotalTimes; // Inclusive, one per frame it showed up in
+	std::vector<double>		frameSelfTimes; // Exclusive
+	ProfilerTimeStats		totalTime;
+	ProfilerTimeStats		selfTime;
+
+	int						lastFrameIndex = -1; // Only used while generating
+};
+
+//-----------------------------------------------------------------------------------------------
+// Columns of AppendCsvRows, times in ms
+#define PROFILER_STATS_CSV_HEADER	"thread,scope,frames,calls,total_mean_ms,total_min_ms,total_max_ms,total_p95_ms,total_p99_ms,self_mean_ms,self_min_ms,self_max_ms,self_p95_ms,self_p99_ms\n"
+
+//-----------------------------------------------------------------------------------------------
+// Flat report aggregated over many frames of one thread. Single frame reports hide the spikes that
+// only happen every few frames
+class ProfilerHistoryReport
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerHistoryReport(){}
+	~ProfilerHistoryReport(){}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int							GetFrameCount() const { return m_frameCount; }
+	const	ProfilerScopeStats*			FindScope( const char* name ) const; // Null if it never showed up
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void						Generate( const std::vector<const ProfilerSample*>& roots ); // Frame roots of one thread
+			void						SortByTotalTime(); // Largest mean first
+			void						SortBySelfTime();
+			void						GetLines( std::vector<std::string>& outLines ) const;
+			void						GetHistogramLines( const ProfilerScopeStats& scope, std::vector<std::string>& outLines ) const; // Of its total time per frame
+			std::string					GetFormattedString() const; // Report and the histogram of the first scope
+			void						PrintReportToConsole( const char* histogramScopeId = nullptr ) const; // Histogram of the first scope if none is given
+			void						AppendCsvRows( const char* threadName, std::string& outCsv ) const; // One row per scope, under the PROFILER_STATS_CSV_HEADER columns
+			void						AppendJson( const char* threadName, std::string& outJson ) const; // The thread as one object
+			void						CollectSample( const ProfilerSample* sample, std::vector<int>& frameScopes );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::vector<ProfilerScopeStats>				m_scopes; // In the order they first showed up, the root first
+	std::unordered_map<const char*, size_t>		m_scopeIndices; // By interned name
+	int											m_frameCount = 0;
+};
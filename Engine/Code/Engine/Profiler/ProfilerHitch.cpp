@@ -0,0 +1,139 @@
+#include "Engine/Profiler/ProfilerHitch.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Profiler/ProfilerReport.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerHitch::ProfilerHitch(int contextFrameCount, int maxFrameCount, double budgetSeconds)
+	: m_contextFrameCount(contextFrameCount)
+	, m_maxFrameCount(maxFrameCount)
+	, m_budgetSeconds(budgetSeconds)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the frame in. A frame over the budget asks for the context frames after it again, so
+// hitches in a row end up in one capture until it is full
+//
+void ProfilerHitch::AddFrame(const ProfilerSample* mainRoot, uint64_t frameNumber, double frameSeconds)
+{
+	ProfilerSample* lastRoot = nullptr;
+	for(const ProfilerSample* root = mainRoot; root != nullptr; root = root->nextSibling)
+	{
+		ProfilerSample* rootCopy = CopySample(root, nullptr);
+		if(lastRoot == nullptr)
+		{
+			m_frames.push_back(rootCopy);
+		}
+		else
+		{
+			lastRoot->nextSibling = rootCopy;
+		}
+		lastRoot = rootCopy;
+	}
+	m_frameNumbers.push_back(frameNumber);
+	m_frameSeconds.push_back(frameSeconds);
+
+	if(frameSeconds > m_budgetSeconds)
+	{
+		if(m_hitchFrameCount == 0)
+		{
+			m_firstHitchFrameNumber = frameNumber;
+		}
+
+		if(frameSeconds > m_worstFrameSeconds)
+		{
+			m_worstFrameSeconds = frameSeconds;
+			m_worstFrameNumber = frameNumber;
+		}
+
+		m_hitchFrameCount++;
+		m_framesToCome = m_contextFrameCount;
+	}
+	else if(m_hitchFrameCount > 0)
+	{
+		m_framesToCome--;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the frames as the profiler's tree report, each thread under a header with the frame
+// time, slow frames marked
+//
+std::string ProfilerHitch::GetFormattedString() const
+{
+	std::string formattedText = Stringf("Hitch at frame %llu: %d frame(s) over the %0.4f ms budget, worst %0.4f ms (frame %llu)\n",
+		(unsigned long long) m_firstHitchFrameNumber,
+		m_hitchFrameCount,
+		m_budgetSeconds * 1000.0,
+		m_worstFrameSeconds * 1000.0,
+		(unsigned long long) m_worstFrameNumber);
+
+	for(size_t frameIndex = 0; frameIndex < m_frames.size(); ++frameIndex)
+	{
+		ProfilerSample* mainRoot = m_frames[frameIndex];
+		double frameSeconds = m_frameSeconds[frameIndex];
+
+		formattedText += Stringf("\n---------- Frame %llu: %0.4f ms%s ----------\n",
+			(unsigned long long) m_frameNumbers[frameIndex],
+			frameSeconds * 1000.0,
+			frameSeconds > m_budgetSeconds ? " OVER BUDGET" : "");
+
+		for(ProfilerSample* root = mainRoot; root != nullptr; root = root->nextSibling)
+		{
+			if(root != mainRoot)
+			{
+				formattedText += Stringf("\n%s\n", root->GetName());
+			}
+
+			ProfilerReport report;
+			report.GenerateTreeFromFrame(root);
+			formattedText += report.GetFormattedString();
+		}
+	}
+
+	return formattedText;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the report to a new file. Returns false if it can't be created
+//
+bool ProfilerHitch::WriteToFile(const char* path) const
+{
+	std::string text = GetFormattedString();
+	return FileWriteToNewFile(path, text.c_str(), text.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the sample and everything under it into the hitch's arena
+//
+ProfilerSample* ProfilerHitch::CopySample(const ProfilerSample* sample, ProfilerSample* parent)
+{
+	ProfilerSample* sampleCopy = m_arena.CreateSample(sample->scope);
+	sampleCopy->startTicks = sample->startTicks;
+	sampleCopy->endTicks = sample->endTicks;
+	sampleCopy->allocCount = sample->allocCount;
+	sampleCopy->allocBytes = sample->allocBytes;
+	if(sample->counters != nullptr)
+	{
+		sampleCopy->counters = m_arena.CreateCounters(*sample->counters);
+	}
+
+	if(parent != nullptr)
+	{
+		parent->AddChild(sampleCopy);
+	}
+
+	for(const ProfilerSample* child = sample->firstChild; child != nullptr; child = child->nextSibling)
+	{
+		CopySample(child, sampleCopy);
+	}
+
+	return sampleCopy;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Engine/Profiler/ProfilerFrameArena.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+struct ProfilerSample;
+
+//-----------------------------------------------------------------------------------------------
+// Frames around a frame that went over the budget, copied out of the history into an arena of
+// its own so they outlive the history slots. Holds the context frames before the slow one, then
+// keeps taking frames until as many have followed the last slow frame, or it holds maxFrameCount
+class ProfilerHitch
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerHitch( int contextFrameCount, int maxFrameCount, double budgetSeconds );
+	~ProfilerHitch() {}
+
+	ProfilerHitch( const ProfilerHitch& ) = delete;
+	ProfilerHitch& operator=( const ProfilerHitch& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool				IsComplete() const { return m_hitchFrameCount > 0 && (m_framesToCome <= 0 || (int) m_frames.size() >= m_maxFrameCount); }
+			size_t				GetFrameCount() const { return m_frames.size(); }
+			int					GetHitchFrameCount() const { return m_hitchFrameCount; }
+			uint64_t			GetFirstHitchFrameNumber() const { return m_firstHitchFrameNumber; }
+			double				GetWorstFrameSeconds() const { return m_worstFrameSeconds; }
+			uint64_t			GetWorstFrameNumber() const { return m_worstFrameNumber; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				AddFrame( const ProfilerSample* mainRoot, uint64_t frameNumber, double frameSeconds ); // Copies the frame, every thread's root included. The time is checked against the budget
+			std::string			GetFormattedString() const; // Tree report of every thread in every frame, oldest frame first
+			bool				WriteToFile( const char* path ) const;
+
+private:
+			ProfilerSample*		CopySample( const ProfilerSample* sample, ProfilerSample* parent );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	ProfilerFrameArena				m_arena;
+	std::vector<ProfilerSample*>	m_frames; // Main thread's roots, the other threads' roots are their siblings
+	std::vector<uint64_t>			m_frameNumbers;
+	std::vector<double>				m_frameSeconds; // As checked against the budget, without the profiler's own writes
+	int								m_contextFrameCount;
+	int								m_maxFrameCount;
+	double							m_budgetSeconds;
+	int								m_framesToCome = 0; // Frames still wanted after the last slow one
+	int								m_hitchFrameCount = 0;
+	uint64_t						m_firstHitchFrameNumber = 0;
+	uint64_t						m_worstFrameNumber = 0;
+	double							m_worstFrameSeconds = 0.0;
+};
@@ -34,7 +34,7 @@ double ProfilerReport::GetTotalFrameTime() const
 //
 void ProfilerReport::GenerateTreeFromFrame(ProfilerSample* root)
 {
-	m_root = new ProfilerReportEntry(root->id);
+	m_root = new ProfilerReportEntry(root->GetName());
 	m_root->PopulateTree(root);
 }
 
@@ -43,7 +43,7 @@ void ProfilerReport::GenerateTreeFromFrame(ProfilerSample* root)
 //
 void ProfilerReport::GenerateFlatFromFrame(ProfilerSample* root)
 {
-	m_root = new ProfilerReportEntry(root->id);
+	m_root = new ProfilerReportEntry(root->GetName());
 	m_root->PopulateFlat(root);
 
 	m_root->CollectDataFromNode(root);
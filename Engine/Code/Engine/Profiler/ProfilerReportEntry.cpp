@@ -1,6 +1,7 @@
 #include "Engine/Profiler/ProfilerReportEntry.hpp"
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
+#include "Engine/Profiler/ProfilerAllocations.hpp"
 #include "Engine/Profiler/ProfilerSample.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Renderer/DebugRenderUtils.hpp"
@@ -8,6 +9,65 @@
 
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Returns the allocation column headers, empty unless allocations are tracked
+//
+static std::string GetAllocationHeaderString()
+{
+	if(!ProfilerIsTrackingAllocations())
+	{
+		return "";
+	}
+
+	return Stringf(" %-8s %-12s %-11s %-12s", "ALLOCS", "BYTES", "SELF ALLOCS", "SELF BYTES");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the entry's allocation columns, empty unless allocations are tracked
+//
+static std::string GetAllocationString(const ProfilerReportEntry* entry)
+{
+	if(!ProfilerIsTrackingAllocations())
+	{
+		return "";
+	}
+
+	return Stringf(" %-8u %-12u %-11u %-12u", entry->m_allocCount, entry->m_allocBytes, entry->m_selfAllocCount, entry->m_selfAllocBytes);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the hardware counter column headers, empty unless some scope reads the counters
+//
+static std::string GetCounterHeaderString()
+{
+	if(!ProfilerHasCountedScopes())
+	{
+		return "";
+	}
+
+	return Stringf(" %-6s %-11s %-12s", "IPC", "CACHE MISS%", "BRANCH MISS%");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the entry's instructions per cycle and miss rates, blank if none of its calls were counted
+//
+static std::string GetCounterString(const ProfilerReportEntry* entry)
+{
+	if(!ProfilerHasCountedScopes())
+	{
+		return "";
+	}
+
+	if(entry->m_countedCallCount == 0)
+	{
+		return Stringf(" %-6s %-11s %-12s", "-", "-", "-");
+	}
+
+	return Stringf(" %-6.2f %-11.2f %-12.2f",
+		entry->m_counters.GetInstructionsPerCycle(),
+		entry->m_counters.GetCacheMissRate() * 100.0,
+		entry->m_counters.GetBranchMissRate() * 100.0);
+}
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -42,17 +102,17 @@ std::string ProfilerReportEntry::GetFormattedString() const
 			"TOTAL%",
 			"SELF TIME");
 		
-		formattedText.append(debugHeaderString + "\n");
+		formattedText.append(debugHeaderString + GetAllocationHeaderString() + GetCounterHeaderString() + "\n");
 	}
 
 	std::string debugString = Stringf("%*s%-*s %-8d (%-8f)ms %-8f (%-8f)ms", 
 		m_indent, "", 
-		40 - m_indent, m_id.c_str(), 
+		40 - m_indent, m_id, 
 		m_callCount, 
 		m_totalTime, 
 		m_percentTime,
 		m_selfTime );
-	formattedText.append(debugString + "\n");
+	formattedText.append(debugString + GetAllocationString(this) + GetCounterString(this) + "\n");
 
 	for(ProfilerReportEntry* child : m_children)
 	{
@@ -70,9 +130,9 @@ void ProfilerReportEntry::PopulateTree(const ProfilerSample* node)
 	CollectDataFromNode(node);
 
 	double childrenTime = 0.0;
-	for(ProfilerSample* child : node->children)
+	for(const ProfilerSample* child = node->firstChild; child != nullptr; child = child->nextSibling)
 	{
-		ProfilerReportEntry* entry = CreateOrGetChild(child->id);
+		ProfilerReportEntry* entry = CreateOrGetChild(child->GetName());
 		entry->PopulateTree(child);
 		childrenTime += entry->m_totalTime;
 	}
@@ -87,9 +147,9 @@ void ProfilerReportEntry::PopulateTree(const ProfilerSample* node)
 //
 void ProfilerReportEntry::PopulateFlat(const ProfilerSample* node)
 {
-	for(ProfilerSample* child : node->children)
+	for(const ProfilerSample* child = node->firstChild; child != nullptr; child = child->nextSibling)
 	{
-		ProfilerReportEntry* entry = CreateOrGetChild(child->id);
+		ProfilerReportEntry* entry = CreateOrGetChild(child->GetName());
 		entry->CollectDataFromNode(child);
 		PopulateFlat(child);
 	}
@@ -107,6 +167,23 @@ void ProfilerReportEntry::CollectDataFromNode(const ProfilerSample* node)
 	m_selfTime = m_totalTime - childrenTime;
 	m_percentTime = m_totalTime / rootTime;
 
+	uint32_t childrenAllocCount;
+	uint32_t childrenAllocBytes;
+	node->GetChildrenAllocations(childrenAllocCount, childrenAllocBytes);
+	m_allocCount += node->allocCount;
+	m_allocBytes += node->allocBytes;
+	m_selfAllocCount += node->allocCount - childrenAllocCount;
+	m_selfAllocBytes += node->allocBytes - childrenAllocBytes;
+
+	if(node->counters != nullptr)
+	{
+		for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex)
+		{
+			m_counters.values[counterIndex] += node->counters->values[counterIndex];
+		}
+		m_countedCallCount++;
+	}
+
 	if(m_parent)
 	{
 		m_indent = m_parent->m_indent + 1;
@@ -124,6 +201,7 @@ ProfilerReportEntry* ProfilerReportEntry::CreateOrGetChild(const char* id)
 		entry = new ProfilerReportEntry(id); 
 		entry->m_parent = this; 
 		m_children.push_back(entry); 
+		m_childrenById[id] = entry;
 	}
 	return entry; 
 }
@@ -133,15 +211,8 @@ ProfilerReportEntry* ProfilerReportEntry::CreateOrGetChild(const char* id)
 //
 const ProfilerReportEntry* ProfilerReportEntry::FindEntry(const char* id) const
 {
-	for(ProfilerReportEntry* child : m_children)
-	{
-		if(child->m_id == id)
-		{
-			return child;
-		}
-	}
-
-	return nullptr;
+	auto childIter = m_childrenById.find(id);
+	return childIter != m_childrenById.end() ? childIter->second : nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -149,15 +220,8 @@ const ProfilerReportEntry* ProfilerReportEntry::FindEntry(const char* id) const
 //
 ProfilerReportEntry* ProfilerReportEntry::FindEntry(const char* id)
 {
-	for(ProfilerReportEntry* child : m_children)
-	{
-		if(child->m_id == id)
-		{
-			return child;
-		}
-	}
-
-	return nullptr;
+	auto childIter = m_childrenById.find(id);
+	return childIter != m_childrenById.end() ? childIter->second : nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -172,6 +236,7 @@ void ProfilerReportEntry::DestroyRecursive()
 	}
 
 	m_children.clear();
+	m_childrenById.clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -188,15 +253,17 @@ void ProfilerReportEntry::PrintToConsole()
 			"TOTAL TIME",
 			"TOTAL%",
 			"SELF TIME");
+		debugHeaderString += GetAllocationHeaderString() + GetCounterHeaderString();
 		ConsolePrintf("%s", debugHeaderString.c_str());
 	}
 	std::string debugString = Stringf("%*s%-*s %-8d (%-8f)ms %-8f (%-8f)ms", 
 		m_indent, "", 
-		45 - m_indent, m_id.c_str(), 
+		45 - m_indent, m_id, 
 		m_callCount, 
 		m_totalTime, 
 		m_percentTime,
 		m_selfTime );
+	debugString += GetAllocationString(this) + GetCounterString(this);
 	ConsolePrintf("%s", debugString.c_str());
 
 	for(ProfilerReportEntry* child : m_children)
@@ -210,7 +277,7 @@ void ProfilerReportEntry::PrintToConsole()
 //
 void ProfilerReportEntry::DebugRender()
 {
-	std::string debugString = Stringf("%*s%-*s %-8d (%-8f)s (%-8f)s", m_indent, "", 45 - m_indent, m_id.c_str(), m_callCount, m_totalTime, m_selfTime );
+	std::string debugString = Stringf("%*s%-*s %-8d (%-8f)s (%-8f)s", m_indent, "", 45 - m_indent, m_id, m_callCount, m_totalTime, m_selfTime );
 	DebugRenderLogf(0.f, "%s", debugString.c_str());
 
 	for(ProfilerReportEntry* child : m_children)
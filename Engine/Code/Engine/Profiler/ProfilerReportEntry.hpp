@@ -1,12 +1,16 @@
 #pragma once
+#include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "Engine/Profiler/ProfilerCounters.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 struct ProfilerSample;
 
 //-----------------------------------------------------------------------------------------------
+// Ids are interned scope names (ProfilerScopeDesc::name), so entries are matched by pointer
 class ProfilerReportEntry
 {
 public:
@@ -38,13 +42,20 @@ public:
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	std::string									m_id; 
-	int											m_indent;
+	const char*									m_id; 
+	int											m_indent = 0;
 	int											m_callCount = 0; 
 	double										m_totalTime = 0.0; // inclusive time; 
 	double										m_selfTime = 0.0;  // exclusive time
-	double										m_percentTime;
-	ProfilerReportEntry*						m_parent; 
+	double										m_percentTime = 0.0;
+	uint32_t									m_allocCount = 0; // inclusive, only counted while the profiler tracks allocations
+	uint32_t									m_allocBytes = 0;
+	uint32_t									m_selfAllocCount = 0; // exclusive
+	uint32_t									m_selfAllocBytes = 0;
+	ProfilerCounterValues						m_counters = {}; // inclusive, summed over the calls that were counted
+	int											m_countedCallCount = 0;
+	ProfilerReportEntry*						m_parent = nullptr; 
 	std::vector<ProfilerReportEntry*>			m_children; 
+	std::unordered_map<const char*, ProfilerReportEntry*>	m_childrenById;
 };
 
@@ -2,41 +2,33 @@
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 #include "Engine/Core/Clock.hpp"
-#include "Engine/Core/Time.hpp"
+#include "Engine/Profiler/ProfilerClock.hpp"
 //-----------------------------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
-ProfilerSample::ProfilerSample( char name[] )
+ProfilerSample::ProfilerSample( const ProfilerScopeDesc* sampleScope )
+	: scope(sampleScope)
 {
-	strcpy_s(id, name);
 	Start();
 }
 
-//-----------------------------------------------------------------------------------------------
-// Destructor
-//
-ProfilerSample::~ProfilerSample()
-{
-	DestroyRecursive();
-}
-
 //-----------------------------------------------------------------------------------------------
 // Starts the measurement
 //
 void ProfilerSample::Start()
 {
-	startHpc = Time::GetPerformanceCounter();
+	startTicks = ProfilerGetTicks();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Finishes the measurement -> Stores the hpc
+// Finishes the measurement -> Stores the ticks
 //
 void ProfilerSample::Finish()
 {
-	endHpc = Time::GetPerformanceCounter();
+	endTicks = ProfilerGetTicksAfter();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -44,23 +36,17 @@ void ProfilerSample::Finish()
 //
 void ProfilerSample::AddChild(ProfilerSample* child)
 {
-	children.push_back(child);
-}
+	child->parent = this;
 
-//-----------------------------------------------------------------------------------------------
-// Recursively destroys the sample and its children
-//
-void ProfilerSample::DestroyRecursive()
-{
-	// Delete the children
-	for(ProfilerSample* child : children)
+	if(lastChild != nullptr)
 	{
-		delete child;
-		child = nullptr;
+		lastChild->nextSibling = child;
 	}
-
-	if(children.size())
-		children.clear();	
+	else
+	{
+		firstChild = child;
+	}
+	lastChild = child;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -68,8 +54,8 @@ void ProfilerSample::DestroyRecursive()
 //
 double ProfilerSample::GetElapsedSeconds() const
 {
-	uint64_t elapsedHpc = endHpc - startHpc;
-	return Time::HpcToSeconds(elapsedHpc);
+	uint64_t elapsedTicks = endTicks - startTicks;
+	return ProfilerTicksToSeconds(elapsedTicks);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -93,10 +79,24 @@ double ProfilerSample::GetRootTotalTime() const
 double ProfilerSample::GetChildrenTotalTime() const
 {
 	double childrenTime = 0.0;
-	for(ProfilerSample* sample : children)
+	for(const ProfilerSample* child = firstChild; child != nullptr; child = child->nextSibling)
 	{
-		childrenTime += sample->GetElapsedSeconds();
+		childrenTime += child->GetElapsedSeconds();
 	}
 
 	return childrenTime;
 }
+
+//-----------------------------------------------------------------------------------------------
+// Returns what the immediate children allocated
+//
+void ProfilerSample::GetChildrenAllocations(uint32_t& outCount, uint32_t& outBytes) const
+{
+	outCount = 0;
+	outBytes = 0;
+	for(const ProfilerSample* child = firstChild; child != nullptr; child = child->nextSibling)
+	{
+		outCount += child->allocCount;
+		outBytes += child->allocBytes;
+	}
+}
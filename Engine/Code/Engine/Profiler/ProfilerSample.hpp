@@ -1,38 +1,49 @@
 #pragma once
 #include <stdint.h>
-#include <vector>
+#include <type_traits>
+#include "Engine/Profiler/ProfilerScope.hpp"
+#include "Engine/Profiler/ProfilerCounters.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Clock;
 
 //-----------------------------------------------------------------------------------------------
+// Allocated from the frame's ProfilerFrameArena and released with it, children are an intrusive
+// list so a push is just the arena slot and a few pointers. The name lives in the scope descriptor
 struct ProfilerSample
 {
 	//-----------------------------------------------------------------------------------------------
 	// Constructors
-	ProfilerSample( char name[] );
-	~ProfilerSample();
+	ProfilerSample( const ProfilerScopeDesc* sampleScope );
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
+	const char*	GetName() const { return scope->name; }
 	void	Start();
 	void	Finish();
 	void	AddChild( ProfilerSample* child );
-	void	DestroyRecursive();
 	double	GetElapsedSeconds() const;
 	double	GetRootTotalTime() const;
 	double	GetChildrenTotalTime() const;
+	void	GetChildrenAllocations( uint32_t& outCount, uint32_t& outBytes ) const;
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	char							id[64];
-	uint64_t						startHpc;
-	uint64_t						endHpc;
+	const ProfilerScopeDesc*		scope;
+	uint64_t						startTicks;
+	uint64_t						endTicks;
+	uint32_t						allocCount = 0; // Allocations made on its thread between start and end, children included
+	uint32_t						allocBytes = 0;
+	ProfilerCounterValues*			counters = nullptr; // Hardware counters over the sample, only for counted scopes that began and ended in the frame
 
 	ProfilerSample*					parent = nullptr;
-	std::vector<ProfilerSample*>	children;
+	ProfilerSample*					firstChild = nullptr;
+	ProfilerSample*					lastChild = nullptr; // Keeps children in call order
+	ProfilerSample*					nextSibling = nullptr;
 };
 
+static_assert(std::is_trivially_destructible<ProfilerSample>::value, "Profiler samples are released by resetting their arena");
+
 
 
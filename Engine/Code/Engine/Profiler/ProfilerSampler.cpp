@@ -0,0 +1,227 @@
+#include "Engine/Profiler/ProfilerSampler.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+#if defined(__linux__)
+//-----------------------------------------------------------------------------------------------
+// Linux Implementation
+//-----------------------------------------------------------------------------------------------
+#include <errno.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define SAMPLER_SKIPPED_FRAMES		3 // RecordSample, the handler and the signal trampoline
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static thread_local ProfilerThreadSampler*	t_threadSampler = nullptr; // Constant initialized, safe to read in the handler
+static std::atomic<bool>					s_isHandlerInstalled{false};
+
+//-----------------------------------------------------------------------------------------------
+// SIGPROF handler, records the interrupted thread's stack if it has a sampler
+//
+static void HandleSampleSignal(int signalNumber, siginfo_t* info, void* context)
+{
+	UNUSED(signalNumber);
+	UNUSED(info);
+	UNUSED(context);
+
+	int savedErrno = errno;
+
+	ProfilerThreadSampler* sampler = t_threadSampler;
+	if(sampler != nullptr)
+	{
+		sampler->RecordSample();
+	}
+
+	errno = savedErrno;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Installs the SIGPROF handler once for the whole process
+//
+static void InstallSampleHandler()
+{
+	if(s_isHandlerInstalled.exchange(true))
+	{
+		return;
+	}
+
+	// backtrace loads the unwinder the first time it runs, which allocates, so that happens here
+	void* warmupFrames[4];
+	backtrace(warmupFrames, 4);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = HandleSampleSignal;
+	action.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGPROF, &action, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerThreadSampler::ProfilerThreadSampler()
+{
+	m_pthread = pthread_self();
+	m_kernelThreadId = (int) syscall(SYS_gettid);
+	t_threadSampler = this;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+ProfilerThreadSampler::~ProfilerThreadSampler()
+{
+	Stop();
+
+	delete m_samples.load(std::memory_order_acquire);
+	m_samples.store(nullptr, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts a timer on the thread's CPU clock that signals it every 1 / samplesPerSecond of CPU time
+// it uses, so idle threads aren't sampled
+//
+bool ProfilerThreadSampler::Start(int samplesPerSecond)
+{
+	Stop();
+
+	if(samplesPerSecond <= 0)
+	{
+		return false;
+	}
+
+	if(m_samples.load(std::memory_order_acquire) == nullptr)
+	{
+		m_samples.store(new SampleRing(), std::memory_order_release);
+	}
+
+	InstallSampleHandler();
+
+	clockid_t threadClock;
+	if(pthread_getcpuclockid(m_pthread, &threadClock) != 0)
+	{
+		return false;
+	}
+
+	timespec cpuTime;
+	clock_gettime(threadClock, &cpuTime);
+	m_lastCpuNanoseconds.store((uint64_t) cpuTime.tv_sec * 1000000000ull + (uint64_t) cpuTime.tv_nsec, std::memory_order_relaxed);
+
+	sigevent timerEvent;
+	memset(&timerEvent, 0, sizeof(timerEvent));
+	timerEvent.sigev_notify = SIGEV_THREAD_ID;
+	timerEvent.sigev_signo = SIGPROF;
+#if defined(sigev_notify_thread_id)
+	timerEvent.sigev_notify_thread_id = m_kernelThreadId;
+#else
+	timerEvent._sigev_un._tid = m_kernelThreadId; // Older headers don't name it
+#endif
+	if(timer_create(threadClock, &timerEvent, &m_timer) != 0)
+	{
+		return false;
+	}
+	m_hasTimer = true;
+
+	long intervalNs = 1000000000L / samplesPerSecond;
+	itimerspec interval;
+	interval.it_interval.tv_sec = intervalNs / 1000000000L;
+	interval.it_interval.tv_nsec = intervalNs % 1000000000L;
+	interval.it_value = interval.it_interval;
+	if(timer_settime(m_timer, 0, &interval, nullptr) != 0)
+	{
+		Stop();
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Deletes the timer, samples already in the ring stay until they are popped
+//
+void ProfilerThreadSampler::Stop()
+{
+	if(m_hasTimer)
+	{
+		timer_delete(m_timer);
+		m_hasTimer = false;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Walks the stack into the ring. Runs in the signal handler, so it only uses backtrace (warmed up
+// by InstallSampleHandler), clock_gettime and the lock free ring
+//
+__attribute__((noinline)) void ProfilerThreadSampler::RecordSample()
+{
+	SampleRing* samples = m_samples.load(std::memory_order_acquire);
+	if(samples == nullptr)
+	{
+		return;
+	}
+
+	void* frames[PROFILER_SAMPLER_MAX_FRAMES + SAMPLER_SKIPPED_FRAMES];
+	int frameCount = backtrace(frames, PROFILER_SAMPLER_MAX_FRAMES + SAMPLER_SKIPPED_FRAMES);
+	if(frameCount <= SAMPLER_SKIPPED_FRAMES)
+	{
+		return;
+	}
+
+	timespec cpuTime;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+	uint64_t cpuNanoseconds = (uint64_t) cpuTime.tv_sec * 1000000000ull + (uint64_t) cpuTime.tv_nsec;
+
+	ProfilerStackSample sample;
+	sample.cpuNanoseconds = cpuNanoseconds - m_lastCpuNanoseconds.exchange(cpuNanoseconds, std::memory_order_relaxed);
+	sample.frameCount = (uint32_t) (frameCount - SAMPLER_SKIPPED_FRAMES);
+	memcpy(sample.frames, frames + SAMPLER_SKIPPED_FRAMES, sample.frameCount * sizeof(void*));
+
+	if(!samples->Push(sample))
+	{
+		m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if this platform can sample
+//
+bool ProfilerSamplerIsSupported()
+{
+	return true;
+}
+
+#else
+//-----------------------------------------------------------------------------------------------
+// Other platforms have no sampling timer
+//-----------------------------------------------------------------------------------------------
+		ProfilerThreadSampler::ProfilerThreadSampler() {}
+		ProfilerThreadSampler::~ProfilerThreadSampler() { delete m_samples.load(std::memory_order_acquire); }
+bool	ProfilerThreadSampler::Start( int samplesPerSecond ) { UNUSED(samplesPerSecond); return false; }
+void	ProfilerThreadSampler::Stop() {}
+void	ProfilerThreadSampler::RecordSample() {}
+bool	ProfilerSamplerIsSupported() { return false; }
+
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Takes the oldest sample out of the ring, returns false if it is empty
+//
+bool ProfilerThreadSampler::PopSample(ProfilerStackSample* outSample)
+{
+	SampleRing* samples = m_samples.load(std::memory_order_acquire);
+	return samples != nullptr && samples->Pop(outSample);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include "Engine/Async/SPSCRingBuffer.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <time.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// One call stack caught by the sampling timer, innermost frame first. The timer fires at most once
+// per scheduler tick whatever rate was asked for, so each sample carries the CPU time it stands for
+struct ProfilerStackSample
+{
+	uint64_t	cpuNanoseconds; // Thread's CPU time since its previous sample
+	uint32_t	frameCount;
+	void*		frames[PROFILER_SAMPLER_MAX_FRAMES];
+};
+
+//-----------------------------------------------------------------------------------------------
+// Samples the call stack of one thread. A timer on the thread's CPU clock sends it SIGPROF, the
+// handler walks the stack into a ring without locks or allocations, and the profiler drains the
+// ring at MarkFrame. Only Linux has it, elsewhere Start fails
+class ProfilerThreadSampler
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerThreadSampler(); // On the thread it samples
+	~ProfilerThreadSampler();
+
+	ProfilerThreadSampler( const ProfilerThreadSampler& ) = delete;
+	ProfilerThreadSampler& operator=( const ProfilerThreadSampler& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			uint64_t	GetDroppedSamples() const { return m_droppedSamples.load(std::memory_order_relaxed); }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool		Start( int samplesPerSecond ); // From any thread, returns false if the timer can't be made
+			void		Stop();
+			bool		PopSample( ProfilerStackSample* outSample ); // Profiler thread only
+			void		RecordSample(); // Signal handler only
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	typedef SPSCRingBuffer<ProfilerStackSample, PROFILER_SAMPLER_RING_SIZE> SampleRing;
+
+	std::atomic<SampleRing*>	m_samples{nullptr}; // Made by the first Start and kept, a signal may still be on its way after Stop
+	std::atomic<uint64_t>		m_droppedSamples{0}; // Ring was full
+	std::atomic<uint64_t>		m_lastCpuNanoseconds{0}; // Thread's CPU time at its last sample, or when sampling started
+#if defined(__linux__)
+	pthread_t					m_pthread;
+	int							m_kernelThreadId = 0;
+	timer_t						m_timer;
+	bool						m_hasTimer = false;
+#endif
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+bool	ProfilerSamplerIsSupported();
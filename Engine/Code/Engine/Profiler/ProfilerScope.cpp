@@ -0,0 +1,149 @@
+#include "Engine/Profiler/ProfilerScope.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Async/Spinlock.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static Spinlock										s_scopesLock;
+static std::deque<ProfilerScopeDesc>				s_scopes; // Deque so descriptors never move
+static std::deque<std::string>						s_scopeNames;
+static std::unordered_map<std::string, const char*>	s_internedNames;
+static std::unordered_map<std::string, const ProfilerScopeDesc*>	s_callSites; // By name, file and line
+static std::unordered_set<const char*>				s_countedNames; // Interned names of scopes that read the hardware counters
+
+//-----------------------------------------------------------------------------------------------
+// Returns the interned copy of the name, adding it if it is new. Must hold the lock
+//
+static const char* InternScopeName(const char* name)
+{
+	auto nameIter = s_internedNames.find(name);
+	if(nameIter != s_internedNames.end())
+	{
+		return nameIter->second;
+	}
+
+	s_scopeNames.emplace_back(name);
+	const char* internedName = s_scopeNames.back().c_str();
+	s_internedNames.emplace(s_scopeNames.back(), internedName);
+	return internedName;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the call site's descriptor, registering it the first time. PROFILE_LOG_SCOPE keeps the
+// result in a static so this only runs once per call site
+//
+const ProfilerScopeDesc* ProfilerRegisterScope(const char* name, const char* file /*= nullptr */, int line /*= 0 */)
+{
+	std::string callSiteKey = std::string(name) + '\n' + (file != nullptr ? file : "") + '\n' + std::to_string(line);
+
+	s_scopesLock.Enter();
+
+	const ProfilerScopeDesc*& scope = s_callSites[callSiteKey];
+	if(scope == nullptr)
+	{
+		s_scopes.emplace_back();
+		ProfilerScopeDesc& newScope = s_scopes.back();
+		newScope.name = InternScopeName(name);
+		newScope.file = file;
+		newScope.line = line;
+		newScope.id = (uint32_t) s_scopes.size() - 1;
+		newScope.recordsCounters.store(s_countedNames.count(newScope.name) > 0, std::memory_order_relaxed);
+
+		scope = &newScope;
+	}
+
+	const ProfilerScopeDesc* result = scope;
+	s_scopesLock.Leave();
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the interned name for lookups by a name typed in, null if no scope has that name
+//
+const char* ProfilerFindScopeName(const char* name)
+{
+	s_scopesLock.Enter();
+
+	auto nameIter = s_internedNames.find(name);
+	const char* internedName = nameIter != s_internedNames.end() ? nameIter->second : nullptr;
+
+	s_scopesLock.Leave();
+
+	return internedName;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns how many call sites have registered
+//
+uint32_t ProfilerGetScopeCount()
+{
+	s_scopesLock.Enter();
+	uint32_t scopeCount = (uint32_t) s_scopes.size();
+	s_scopesLock.Leave();
+
+	return scopeCount;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Picks whether every scope with the name reads the hardware counters. Threads check the flag as
+// their scopes begin, so a change applies from the next begin
+//
+void ProfilerSetScopeCounters(const char* name, bool recordsCounters)
+{
+	s_scopesLock.Enter();
+
+	const char* internedName = InternScopeName(name);
+	if(recordsCounters)
+	{
+		s_countedNames.insert(internedName);
+	}
+	else
+	{
+		s_countedNames.erase(internedName);
+	}
+
+	for(ProfilerScopeDesc& scope : s_scopes)
+	{
+		if(scope.name == internedName)
+		{
+			scope.recordsCounters.store(recordsCounters, std::memory_order_relaxed);
+		}
+	}
+
+	s_scopesLock.Leave();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the names picked to read the hardware counters
+//
+std::vector<std::string> ProfilerGetCountedScopeNames()
+{
+	s_scopesLock.Enter();
+	std::vector<std::string> names(s_countedNames.begin(), s_countedNames.end());
+	s_scopesLock.Leave();
+
+	return names;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if any name is picked to read the hardware counters
+//
+bool ProfilerHasCountedScopes()
+{
+	s_scopesLock.Enter();
+	bool hasCountedScopes = !s_countedNames.empty();
+	s_scopesLock.Leave();
+
+	return hasCountedScopes;
+}
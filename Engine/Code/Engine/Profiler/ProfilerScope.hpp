@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// One profiled call site, registered once and never freed. Samples only keep a pointer to it. The
+// name is interned, so two scopes have the same name exactly when their name pointers are equal
+struct ProfilerScopeDesc
+{
+	const char*	name;
+	const char*	file; // Null for scopes registered at runtime
+	int			line;
+	uint32_t	id; // Registration order, from 0
+	std::atomic<bool>	recordsCounters{false}; // Reads the hardware counters at its begin and end, picked by name
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+const ProfilerScopeDesc*	ProfilerRegisterScope( const char* name, const char* file = nullptr, int line = 0 ); // Returns the same descriptor for the same call site
+const char*					ProfilerFindScopeName( const char* name ); // Interned copy of the name, null if no scope has it
+uint32_t					ProfilerGetScopeCount();
+void						ProfilerSetScopeCounters( const char* name, bool recordsCounters ); // Also applies to scopes of that name registered later
+std::vector<std::string>	ProfilerGetCountedScopeNames();
+bool						ProfilerHasCountedScopes();
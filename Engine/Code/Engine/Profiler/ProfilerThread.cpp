@@ -0,0 +1,238 @@
+#include "Engine/Profiler/ProfilerThread.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Profiler/ProfilerClock.hpp"
+#include "Engine/Profiler/ProfilerFrameArena.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+#include "Engine/Profiler/ProfilerScope.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <algorithm>
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Holds the thread's allocation totals in the sample until it ends
+//
+static void BeginAllocations(ProfilerSample* sample, const ProfilerAllocations& allocations)
+{
+	sample->allocCount = allocations.count;
+	sample->allocBytes = allocations.bytes;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns the totals held since the sample began into what it allocated
+//
+static void EndAllocations(ProfilerSample* sample, const ProfilerAllocations& allocations)
+{
+	sample->allocCount = allocations.count - sample->allocCount;
+	sample->allocBytes = allocations.bytes - sample->allocBytes;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns the readings held since the sample began into what it counted. Without a reading at the
+// end (cut at the end of the frame) the sample has no counters
+//
+static void EndCounters(ProfilerSample* sample, const ProfilerCounterValues* endValues)
+{
+	if(sample->counters == nullptr)
+	{
+		return;
+	}
+
+	if(endValues == nullptr)
+	{
+		sample->counters = nullptr;
+		return;
+	}
+
+	for(int counterIndex = 0; counterIndex < NUM_PROFILER_COUNTERS; ++counterIndex)
+	{
+		sample->counters->values[counterIndex] = endValues->values[counterIndex] - sample->counters->values[counterIndex];
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerThread::ProfilerThread(const char* name, uintptr_t threadId)
+	: m_threadId(threadId)
+{
+	m_rootScope = ProfilerRegisterScope(name);
+	m_lastAllocations = ProfilerGetThreadAllocations(); // Constructed on the owner thread
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the thread's name, interned so it outlives the thread
+//
+const char* ProfilerThread::GetName() const
+{
+	return m_rootScope->name;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if events are waiting for the next frame
+//
+bool ProfilerThread::HasPendingEvents() const
+{
+	return m_hasPendingEvent || !m_events.IsEmpty();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the start of a scope. A begin only goes in if there is room left for its end and the ends
+// of every scope already open, otherwise the scope and everything inside it is dropped
+//
+void ProfilerThread::Push(const ProfilerScopeDesc* scope)
+{
+	if(m_skipDepth == 0 && m_events.GetCapacity() - m_events.GetSize() >= (size_t) m_recordedDepth + 2)
+	{
+		// Counted the same way, with room kept for the readings of every counted scope still open
+		ProfilerCounterValues counterValues;
+		bool hasCounters = scope->recordsCounters.load(std::memory_order_relaxed)
+			&& m_recordedDepth < 64
+			&& m_counterReadings.GetCapacity() - m_counterReadings.GetSize() >= (size_t) m_countedOpenScopes + 2
+			&& m_counters.Open()
+			&& m_counters.Read(&counterValues);
+
+		uint64_t ticks = ProfilerGetTicks();
+		if(hasCounters)
+		{
+			m_counterReadings.Push(counterValues); // Before its event, which makes it visible
+			m_countedDepths |= (uint64_t) 1 << m_recordedDepth;
+			m_countedOpenScopes++;
+		}
+
+		m_events.Push({ scope, ticks, ProfilerGetThreadAllocations(), hasCounters });
+		m_recordedDepth++;
+		return;
+	}
+
+	if(m_skipDepth == 0)
+	{
+		m_droppedScopes.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_skipDepth++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the end of the innermost scope. Never waits, its room was kept when it began
+//
+void ProfilerThread::Pop()
+{
+	if(m_skipDepth > 0)
+	{
+		m_skipDepth--;
+	}
+	else if(m_recordedDepth > 0) // Otherwise it began before the thread was registered
+	{
+		m_recordedDepth--;
+
+		uint64_t ticks = ProfilerGetTicksAfter();
+
+		// Scopes this deep never read the counters, and shifting by 64 or more is undefined
+		uint64_t countedBit = m_recordedDepth < 64 ? (uint64_t) 1 << m_recordedDepth : 0;
+		bool hasCounters = m_recordedDepth < 64 && (m_countedDepths & countedBit) != 0;
+		if(hasCounters)
+		{
+			ProfilerCounterValues counterValues;
+			if(!m_counters.Read(&counterValues))
+			{
+				memset(&counterValues, 0, sizeof(counterValues));
+			}
+			m_counterReadings.Push(counterValues);
+			m_countedDepths &= ~countedBit;
+			m_countedOpenScopes--;
+		}
+
+		m_events.Push({ nullptr, ticks, ProfilerGetThreadAllocations(), hasCounters });
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns everything recorded up to frameEndTicks into a tree under a root spanning the frame
+//
+ProfilerSample* ProfilerThread::BuildFrame(ProfilerFrameArena& arena, const ProfilerScopeDesc* rootScope, uint64_t frameStartTicks, uint64_t frameEndTicks)
+{
+	ProfilerSample* root = arena.CreateSample(rootScope);
+	root->startTicks = frameStartTicks;
+	root->endTicks = frameEndTicks;
+	BeginAllocations(root, m_lastAllocations);
+
+	// Scopes cut at the end of the last frame carry on from the start of this one
+	m_openSamples.clear();
+	for(const ProfilerScopeDesc* scope : m_openScopes)
+	{
+		ProfilerSample* sample = arena.CreateSample(scope);
+		sample->startTicks = frameStartTicks;
+		BeginAllocations(sample, m_lastAllocations);
+		(m_openSamples.empty() ? root : m_openSamples.back())->AddChild(sample);
+		m_openSamples.push_back(sample);
+	}
+
+	while(true)
+	{
+		ProfilerEvent event;
+		if(m_hasPendingEvent)
+		{
+			event = m_pendingEvent;
+			m_hasPendingEvent = false;
+		}
+		else if(!m_events.Pop(&event))
+		{
+			break;
+		}
+
+		if(event.ticks > frameEndTicks)
+		{
+			m_pendingEvent = event;
+			m_hasPendingEvent = true;
+			break;
+		}
+
+		// Anything recorded before the profiler's first frame counts from the start of this one
+		event.ticks = std::max(event.ticks, frameStartTicks);
+		m_lastAllocations = event.allocations;
+
+		ProfilerCounterValues counterValues;
+		if(event.hasCounters)
+		{
+			m_counterReadings.Pop(&counterValues);
+		}
+
+		if(event.scope != nullptr)
+		{
+			ProfilerSample* sample = arena.CreateSample(event.scope);
+			sample->startTicks = event.ticks;
+			BeginAllocations(sample, event.allocations);
+			if(event.hasCounters)
+			{
+				sample->counters = arena.CreateCounters(counterValues); // Readings at the begin until it ends
+			}
+			(m_openSamples.empty() ? root : m_openSamples.back())->AddChild(sample);
+			m_openSamples.push_back(sample);
+			m_openScopes.push_back(event.scope);
+		}
+		else if(!m_openSamples.empty()) // Otherwise the scope began before the profiler was started
+		{
+			m_openSamples.back()->endTicks = event.ticks;
+			EndAllocations(m_openSamples.back(), event.allocations);
+			EndCounters(m_openSamples.back(), event.hasCounters ? &counterValues : nullptr);
+			m_openSamples.pop_back();
+			m_openScopes.pop_back();
+		}
+	}
+
+	// Whatever is still open is cut at the end of the frame. Allocations after the newest event
+	// are counted in the next frame
+	for(ProfilerSample* sample : m_openSamples)
+	{
+		sample->endTicks = frameEndTicks;
+		EndAllocations(sample, m_lastAllocations);
+		EndCounters(sample, nullptr);
+	}
+	EndAllocations(root, m_lastAllocations);
+
+	return root;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+#include "Engine/Async/SPSCRingBuffer.hpp"
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Profiler/ProfilerAllocations.hpp"
+#include "Engine/Profiler/ProfilerCounters.hpp"
+#include "Engine/Profiler/ProfilerSampler.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class ProfilerFrameArena;
+struct ProfilerSample;
+struct ProfilerScopeDesc;
+
+//-----------------------------------------------------------------------------------------------
+struct ProfilerEvent
+{
+	const ProfilerScopeDesc*	scope;	// Null for the end of a scope
+	uint64_t					ticks;
+	ProfilerAllocations			allocations; // Thread's totals when the event was recorded
+	bool						hasCounters; // A counter reading was recorded with it
+};
+
+//-----------------------------------------------------------------------------------------------
+// One profiled thread. The thread records scope begins and ends into its own ring without locks,
+// the profiler turns them into a sample tree per frame at MarkFrame. Scopes still open at the end
+// of a frame are cut there and carried on in the next one
+class ProfilerThread
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerThread( const char* name, uintptr_t threadId );
+	~ProfilerThread() {}
+
+	ProfilerThread( const ProfilerThread& ) = delete;
+	ProfilerThread& operator=( const ProfilerThread& ) = delete;
+	ALIGNED_NEW_AND_DELETE(ProfilerThread) // Its rings keep head and tail on separate cache lines
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			const char*		GetName() const;
+			const ProfilerScopeDesc*	GetRootScope() const { return m_rootScope; } // Named after the thread
+			uintptr_t		GetThreadID() const { return m_threadId; }
+			uint64_t		GetDroppedScopes() const { return m_droppedScopes.load(std::memory_order_relaxed); }
+			bool			IsOrphaned() const { return m_isOrphaned.load(std::memory_order_acquire); }
+			void			MarkOrphaned() { m_isOrphaned.store(true, std::memory_order_release); } // Owner thread has exited
+			bool			HasPendingEvents() const; // Recorded but not yet built into a frame
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+
+	// Owner thread only
+			void			Push( const ProfilerScopeDesc* scope );
+			void			Pop();
+
+	// Profiler thread only
+			ProfilerSample*	BuildFrame( ProfilerFrameArena& arena, const ProfilerScopeDesc* rootScope, uint64_t frameStartTicks, uint64_t frameEndTicks );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	SPSCRingBuffer<ProfilerEvent, PROFILER_THREAD_EVENTS>	m_events;
+	int							m_recordedDepth = 0; // Owner only, scopes recorded that haven't ended
+	int							m_skipDepth = 0; // Owner only, depth of scopes dropped because the ring was full
+	SPSCRingBuffer<ProfilerCounterValues, PROFILER_THREAD_COUNTER_READINGS>	m_counterReadings; // One per event that has counters, in the same order
+	ProfilerCounterGroup		m_counters; // Owner only, opened by the first counted scope
+	uint64_t					m_countedDepths = 0; // Owner only, bit n is set if the open scope at depth n is counted
+	int							m_countedOpenScopes = 0; // Owner only
+	ProfilerThreadSampler		m_sampler; // Made on the owner thread with the rest, only runs in sampling mode
+	std::atomic<uint64_t>		m_droppedScopes{0};
+	std::vector<const ProfilerScopeDesc*>	m_openScopes; // Profiler thread only, scopes open at the end of the last frame, outermost first
+	std::vector<ProfilerSample*>	m_openSamples; // Profiler thread only, stack while building a frame
+	ProfilerAllocations			m_lastAllocations = { 0, 0 }; // Profiler thread only, totals of the newest event built into a frame
+	ProfilerEvent				m_pendingEvent; // Drained past the end of the frame, belongs to the next one
+	bool						m_hasPendingEvent = false;
+	const ProfilerScopeDesc*	m_rootScope = nullptr;
+	uintptr_t					m_threadId = 0;
+	std::atomic<bool>			m_isOrphaned{false};
+	ProfilerThread*				m_next = nullptr; // Profiler's list of threads
+};
@@ -0,0 +1,202 @@
+#include "Engine/Profiler/ProfilerTraceWriter.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Profiler/ProfilerClock.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Profiler/ProfilerSample.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define TRACE_PROCESS_ID		1
+#define TRACE_FLUSH_SIZE		(64 * 1024) // Buffered events are written out past this size
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfilerTraceWriter::ProfilerTraceWriter()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+ProfilerTraceWriter::~ProfilerTraceWriter()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the trace file. Returns false if it can't be created
+//
+bool ProfilerTraceWriter::Open(const char* path)
+{
+	Close();
+
+	m_file = new File();
+	if(m_file->Open(path, FILE_WRITE) != 0) // fopen error codes
+	{
+		delete m_file;
+		m_file = nullptr;
+		return false;
+	}
+
+	m_buffer = "[\n";
+	m_trackIndices.clear();
+	m_baseTicks = 0;
+	m_frameCount = 0;
+	m_hasEvents = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ends the event array and closes the file
+//
+void ProfilerTraceWriter::Close()
+{
+	if(m_file == nullptr)
+	{
+		return;
+	}
+
+	m_buffer += "\n]\n";
+	Flush();
+
+	m_file->Close();
+	delete m_file;
+	m_file = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds every thread's samples of the frame. Thread roots only name the track, their children are
+// the events
+//
+void ProfilerTraceWriter::WriteFrame(const ProfilerSample* mainRoot)
+{
+	if(m_file == nullptr || mainRoot == nullptr)
+	{
+		return;
+	}
+
+	if(m_frameCount == 0)
+	{
+		m_baseTicks = mainRoot->startTicks;
+	}
+	m_frameCount++;
+
+	WriteSample(mainRoot, GetTrackIndex(nullptr));
+
+	for(const ProfilerSample* root = mainRoot->nextSibling; root != nullptr; root = root->nextSibling)
+	{
+		int trackIndex = GetTrackIndex(root->GetName());
+		for(const ProfilerSample* child = root->firstChild; child != nullptr; child = child->nextSibling)
+		{
+			WriteSample(child, trackIndex);
+		}
+	}
+
+	if(m_buffer.size() >= TRACE_FLUSH_SIZE)
+	{
+		Flush();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes out the buffered events
+//
+void ProfilerTraceWriter::Flush()
+{
+	if(m_file == nullptr || m_buffer.empty())
+	{
+		return;
+	}
+
+	FileWriteSpan span = { m_buffer.data(), m_buffer.size() };
+	m_file->WriteGather(&span, 1);
+	m_file->Flush();
+	m_buffer.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the thread's track, naming it the first time it is seen. No name means the main thread
+//
+int ProfilerTraceWriter::GetTrackIndex(const char* threadName)
+{
+	std::string trackName = threadName != nullptr ? threadName : PROFILER_MAIN_THREAD_NAME;
+
+	auto trackIter = m_trackIndices.find(trackName);
+	if(trackIter != m_trackIndices.end())
+	{
+		return trackIter->second;
+	}
+
+	int trackIndex = (int) m_trackIndices.size();
+	m_trackIndices[trackName] = trackIndex;
+
+	char event[128];
+
+	AppendEventStart();
+	snprintf(event, sizeof(event), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", TRACE_PROCESS_ID, trackIndex);
+	m_buffer += event;
+	AppendJsonString(m_buffer, trackName.c_str());
+	m_buffer += "}}";
+
+	// Tracks stay in the order the threads first showed up
+	AppendEventStart();
+	snprintf(event, sizeof(event), "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"sort_index\":%d}}", TRACE_PROCESS_ID, trackIndex, trackIndex);
+	m_buffer += event;
+
+	return trackIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the sample and its children as complete events
+//
+void ProfilerTraceWriter::WriteSample(const ProfilerSample* sample, int trackIndex)
+{
+	char event[128];
+
+	AppendEventStart();
+	m_buffer += "{\"name\":";
+	AppendJsonString(m_buffer, sample->GetName());
+	snprintf(event, sizeof(event), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+		GetTimestampUs(sample->startTicks), ProfilerTicksToSeconds(sample->endTicks - sample->startTicks) * 1000000.0, TRACE_PROCESS_ID, trackIndex);
+	m_buffer += event;
+
+	for(const ProfilerSample* child = sample->firstChild; child != nullptr; child = child->nextSibling)
+	{
+		WriteSample(child, trackIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Separates the event from the one before it
+//
+void ProfilerTraceWriter::AppendEventStart()
+{
+	if(m_hasEvents)
+	{
+		m_buffer += ",\n";
+	}
+	m_hasEvents = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Microseconds since the start of the first frame written
+//
+double ProfilerTraceWriter::GetTimestampUs(uint64_t ticks) const
+{
+	if(ticks < m_baseTicks)
+	{
+		return -ProfilerTicksToSeconds(m_baseTicks - ticks) * 1000000.0;
+	}
+
+	return ProfilerTicksToSeconds(ticks - m_baseTicks) * 1000000.0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class File;
+struct ProfilerSample;
+
+//-----------------------------------------------------------------------------------------------
+// Writes profiler frames as Chrome trace events (JSON array format), for chrome://tracing and
+// Perfetto. Every thread of a frame gets its own track, named after the thread. The array is left
+// open until Close, the viewers still load a file cut short by a crash
+class ProfilerTraceWriter
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfilerTraceWriter();
+	~ProfilerTraceWriter();
+
+	ProfilerTraceWriter( const ProfilerTraceWriter& ) = delete;
+	ProfilerTraceWriter& operator=( const ProfilerTraceWriter& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool		IsOpen() const { return m_file != nullptr; }
+			uint64_t	GetFrameCount() const { return m_frameCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool		Open( const char* path );
+			void		Close();
+			void		WriteFrame( const ProfilerSample* mainRoot ); // Main thread's root, the other threads' roots are its siblings
+			void		Flush();
+
+private:
+			int			GetTrackIndex( const char* threadName );
+			void		WriteSample( const ProfilerSample* sample, int trackIndex );
+			void		AppendEventStart();
+			double		GetTimestampUs( uint64_t ticks ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	File*								m_file = nullptr;
+	std::string							m_buffer; // Events of the frame being written
+	std::unordered_map<std::string, int>	m_trackIndices; // By thread name, the main thread is 0
+	uint64_t							m_baseTicks = 0; // Timestamps count from the start of the first frame
+	uint64_t							m_frameCount = 0;
+	bool								m_hasEvents = false;
+};
@@ -24,6 +24,10 @@
 #include "Engine/Console/CommandDefinition.hpp"
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Defines
+#define HEADLESS_STATS_FILE		"Log/profiler_stats" // Extension is added per format
+
 //-----------------------------------------------------------------------------------------------
 // Static globals
 static App* g_theApp = nullptr;
@@ -126,8 +130,63 @@ void App::RunFrame()
 	Profiler::MarkFrame();
 	BeginFrame();
 	Update();
-	Render();
+	if(!m_isHeadless)
+	{
+		Render();
+	}
 	EndFrame();
+
+	if(m_isHeadless && --m_headlessFramesLeft <= 0)
+	{
+		RequestQuit();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs the script, then the given number of frames without rendering anything. With only a
+// script the run lasts a full profiler history
+//
+void App::StartHeadlessRun(int frameCount, const char* scriptPath, const char* statsPath)
+{
+	m_isHeadless = true;
+	m_headlessFramesLeft = frameCount > 0 ? frameCount : PROFILER_HISTORY_SIZE;
+	m_statsPath = statsPath[0] != '\0' ? statsPath : HEADLESS_STATS_FILE;
+
+	if(scriptPath[0] != '\0')
+	{
+		Command::CommandRunScriptFile(scriptPath);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the scope stats of the headless run, true if the app wasn't running headless
+//
+bool App::FinishHeadlessRun()
+{
+	if(!m_isHeadless)
+	{
+		return true;
+	}
+
+	// Closes the last frame so it makes the history
+	Profiler::MarkFrame();
+
+	Profiler* profiler = Profiler::GetInstance();
+	if(profiler == nullptr)
+	{
+		DebuggerPrintf("Profiling is disabled, no stats written\n");
+		return false;
+	}
+
+	bool hasWrittenCsv = profiler->ExportStats((m_statsPath + ".csv").c_str());
+	bool hasWrittenJson = profiler->ExportStats((m_statsPath + ".json").c_str());
+	if(!hasWrittenCsv || !hasWrittenJson)
+	{
+		DebuggerPrintf("Couldn't write the profiler stats to %s\n", m_statsPath.c_str());
+		return false;
+	}
+
+	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -22,6 +23,8 @@ public:
 	void RunFrame();
 	void RequestQuit();
 	void HandleKeyboardInput();
+	void StartHeadlessRun( int frameCount, const char* scriptPath, const char* statsPath ); // No rendering, quits after the frames
+	bool FinishHeadlessRun(); // Writes the profiler stats, false if they couldn't be written
 
 	//-----------------------------------------------------------------------------------------------
 	// Static methods
@@ -39,6 +42,9 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Member Variables
 	bool m_isQuitting = false;
+	bool m_isHeadless = false;
+	int m_headlessFramesLeft = 0;
+	std::string m_statsPath; // Written as .csv and .json
 };
 
 
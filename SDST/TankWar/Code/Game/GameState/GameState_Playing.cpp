@@ -42,8 +42,17 @@
 #include "Engine/Math/RaycastHit3D.hpp"
 #include "Engine/Math/Ray3.hpp"
 #include "Engine/Core/StopWatch.hpp"
+#include "Engine/Async/JobSystem.hpp"
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Job data for updating a particle emitter on a job worker
+struct EmitterUpdateJobData
+{
+	ParticleEmitter*	emitter;
+	float				deltaSeconds;
+};
+
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
@@ -295,11 +304,7 @@ void GameState_Playing::Update(float deltaSeconds)
 		bullet->Update(deltaSeconds);
 	}
 
-	for(ParticleEmitter* emitter : m_emitters)
-	{
-		emitter->Update(deltaSeconds);
-		emitter->PreRender(m_scene->m_cameras[0]);
-	}
+	UpdateEmitters(deltaSeconds);
 
 	for(size_t index = 0; index < m_emitters.size(); ++index)
 	{
@@ -322,6 +327,40 @@ void GameState_Playing::Update(float deltaSeconds)
 
 }
 
+//-----------------------------------------------------------------------------------------------
+// Updates the particle emitters across the job workers, then builds their meshes on this thread
+//
+void GameState_Playing::UpdateEmitters(float deltaSeconds)
+{
+	JobHandle emittersJob = JobCreate(nullptr);
+
+	for(ParticleEmitter* emitter : m_emitters)
+	{
+		// Resolve the lazy world matrix here so the workers only read the transform hierarchy
+		emitter->m_transform->GetWorldMatrix();
+
+		EmitterUpdateJobData data = { emitter, deltaSeconds };
+		JobRun(JobCreateChildWithData(emittersJob, UpdateEmitterJob, &data, sizeof(data)));
+	}
+
+	JobRun(emittersJob);
+	JobWait(emittersJob);
+
+	for(ParticleEmitter* emitter : m_emitters)
+	{
+		emitter->PreRender(m_scene->m_cameras[0]);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Job callback that updates a single particle emitter
+//
+void GameState_Playing::UpdateEmitterJob(void* userData)
+{
+	EmitterUpdateJobData* data = (EmitterUpdateJobData*) userData;
+	data->emitter->Update(data->deltaSeconds);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Renders the debug stuff
 //
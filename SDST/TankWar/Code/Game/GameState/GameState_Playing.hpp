@@ -48,6 +48,7 @@ public:
 	virtual void			ProcessInput() override;
 	virtual void			ProcessMouseInput() override;
 	virtual void			Update( float deltaSeconds ) override;
+			void			UpdateEmitters( float deltaSeconds );
 			void			DebugRender();
 	virtual void			Render() const override;
 			void			RenderUI() const;
@@ -79,6 +80,10 @@ public:
 	// Command Callbacks
 	static	bool			KillAllCommand( Command& cmd );
 
+	//-----------------------------------------------------------------------------------------------
+	// Job Callbacks
+	static	void			UpdateEmitterJob( void* userData );
+
 	//-----------------------------------------------------------------------------------------------
 	// Members
 	int								m_renderMode = 0;
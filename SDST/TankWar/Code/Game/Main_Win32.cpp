@@ -15,6 +15,7 @@
 #include "Engine/Console/CommandDefinition.hpp"
 #include "Engine/Console/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/StringTokenizer.hpp"
 
 const char* APP_NAME = "Kevin Nappoly: Basic Triangle ModernGL";	
 
@@ -185,9 +186,9 @@ bool QuitCommand(Command& cmd)
 //-----------------------------------------------------------------------------------------------
 // Creates the OpenGL Window
 //
-void CreateOpenGLWindow( float clientAspect )
+void CreateOpenGLWindow( float clientAspect, bool isVisible )
 {
-	Window *window = Window::CreateInstance( APP_NAME, clientAspect ); 
+	Window *window = Window::CreateInstance( APP_NAME, clientAspect, isVisible ); 
 	window->AddHandler( AppMessageHandler ); 
 	window->AddHandler( ConsoleInputHandler );
 }
@@ -201,14 +202,46 @@ void RunFrame()
 }
 
 //-----------------------------------------------------------------------------------------------
-void Initialize()
+// "-frames <count>" and/or "-script <file>" run the game headless for profiling, "-stats <file>"
+// picks where its stats are written
+//
+void Initialize( const char* commandLineString )
 {
-	CreateOpenGLWindow( CLIENT_ASPECT );
+	int frameCount = 0;
+	std::string scriptPath;
+	std::string statsPath;
+
+	StringTokenizer tokenizer(commandLineString, " ");
+	tokenizer.Tokenize();
+	tokenizer.TrimEmpty();
+	Strings arguments = tokenizer.GetTokens();
+	for(size_t argIndex = 0; argIndex + 1 < arguments.size(); ++argIndex)
+	{
+		if(arguments[argIndex] == "-frames")
+		{
+			frameCount = atoi(arguments[++argIndex].c_str());
+		}
+		else if(arguments[argIndex] == "-script")
+		{
+			scriptPath = arguments[++argIndex];
+		}
+		else if(arguments[argIndex] == "-stats")
+		{
+			statsPath = arguments[++argIndex];
+		}
+	}
+
+	bool isHeadless = frameCount > 0 || !scriptPath.empty();
+	CreateOpenGLWindow( CLIENT_ASPECT, !isHeadless );
 	
 	App::CreateInstance();
 	
 	COMMAND("quit", QuitCommand, "Quits the application"); // Registers the quit command
 	
+	if(isHeadless)
+	{
+		App::GetInstance()->StartHeadlessRun(frameCount, scriptPath.c_str(), statsPath.c_str());
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -224,9 +257,8 @@ void Shutdown()
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int )
 {
-	UNUSED( commandLineString );
 	UNUSED( applicationInstanceHandle );
-	Initialize();
+	Initialize( commandLineString );
 
 	// Program main loop; keep running frames until it's time to quit
 	while( !App::GetInstance()->IsQuitting() ) 
@@ -234,8 +266,11 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 		RunFrame();
 	}
 
+	// Headless runs fail if their stats can't be written, so scripts running them notice
+	bool hasFinished = App::GetInstance()->FinishHeadlessRun();
+
 	Shutdown();
-	return 0;
+	return hasFinished ? 0 : 1;
 }
 
 